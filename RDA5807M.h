@@ -19,88 +19,165 @@
  * The latest version of this library can always be found at it's github page,
  * https://github.com/wirbel-at-vdr-portal/RDA5807M
  ******************************************************************************/
+#ifndef RDA5807M_H
+#define RDA5807M_H
+
 #include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M_Trace.h"
+#include "RDA5807M_Status.h"
+#include "RDA5807M_Reg.h"
+#include "RDA5807M_Ring.h"
 
-class RDA5807M {
+/*******************************************************************************
+ * The driver is a class template on it's I2C transport, so that the bus calls
+ * are resolved at compile time and can be inlined. A Transport class has to
+ * provide the following members:
+ *
+ *   bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count);
+ *      one write transaction, terminated by a stop condition.
+ *
+ *   bool Read(uint8_t Address, uint8_t* Data, uint8_t Count);
+ *      one read transaction of Count bytes.
+ *
+ *   bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+ *                  uint8_t* In, uint8_t InCount);
+ *      a write followed by a read using a repeated start.
+ *
+ *   unsigned long Millis(void);
+ *      monotonic time base in milliseconds.
+ *
+ *   void Print(const char* s);
+ *      debug output.
+ *
+ *   unsigned long Micros(void);
+ *      only for RDA5807M_Traced, time base in microseconds.
+ *
+ * All functions returning bool return true on success.
+ * On Arduino, RDA5807M is the driver using the global Wire object.
+ ******************************************************************************/
+template<class Transport>
+class RDA5807M_Driver {
 private:
+  static constexpr uint8_t Address = 0x10; // 7-bit I2C chip address (0010000b)
+  Transport bus;
+  typedef RDA5807M_Tracer<Transport> Tracer;
   uint16_t CHIPID;
-  uint16_t b1,b2,b3,b4,b5,b6,b7;
-  uint16_t Wr[7]; // 0x02..0x08
-  uint16_t Rd[6]; // 0x0A..0x0F
-  bool RDSR;
-  bool STC;
-  bool SF;
-  bool RDSS;
-  bool BLK_E;
-  bool ST;
-  uint16_t READCHAN;
-  uint16_t RSSI;
-  bool FM_TRUE;
-  bool FM_READY;
-  bool ABCD_E;
-  uint8_t BLERA,BLERB;
-  uint16_t RDSA,RDSB,RDSC,RDSD;
-
-  bool DHIZ,DMUTE,MONO,BASS;
-  bool RCLK_NON_CALIBRATE_MODE;
-  bool RCLK_DIRECT_INPUT_MODE;
-  bool SKMODE,SEEK,SEEKUP;
-  uint8_t CLK_MODE;
-  bool RDS_EN,NEW_METHOD,SOFT_RESET;
-  bool ENABLE;
-  uint16_t CHAN;
-  bool DIRECT_MODE;
-  bool TUNE;
-  uint8_t BAND;
-  uint8_t SPACE;
-  bool STCIEN;
-  bool RBDS;
-  bool RDS_FIFO_EN;
-  bool DE;
-  bool RDS_FIFO_CLR;
-  bool SOFTMUTE_EN;
-  bool AFCD;
-  bool I2S_ENABLE;
-  uint8_t GPIO3,GPIO2,GPIO1;
-  bool INT_MODE;
-  uint8_t Seek_mode;
-  uint8_t SEEKTH;
-  uint8_t LNA_PORT_SEL;
-  uint8_t LNA_ICSEL_BIT;
-  uint8_t VOLUME;
-  uint8_t OPEN_MODE;
-  bool slave_master;
-  bool ws_lr;
-  bool sclk_i_edge;
-  bool data_signed;
-  bool WS_I_EDGE;
-  uint8_t I2S_SW_CNT;
-  bool SW_O_EDGE;
-  bool SCLK_O_EDGE;
-  bool L_DELY;
-  bool R_DELY;
-  uint8_t TH_SOFTBLEND;
-  bool MODE_65MHz;
-  uint8_t SEEK_TH_OLD;
-  bool SOFTBLEND_EN;
-  bool FREQ_MODE;
-  uint16_t freq_direct;
-
- 
-
-
-  unsigned long lastRead;
+  unsigned long bootTime;
+  uint16_t Wr[7];   // 0x02..0x08, register shadow
+  uint8_t  dirty;   // bit n set: 0x02+n not yet written to the chip
+  RDA5807M_Status status; // last read of 0x0A..0x0F
+
+  void Put(RDA5807M_Field F, uint16_t Value);
+  uint16_t Field(RDA5807M_Field F) const;
+
+  static constexpr unsigned long DefaultMaxAge = 500;
+  unsigned long readAt[3];
+  unsigned long maxAge[3];
+  bool tuning;
+  bool Read(uint8_t Words = 6);
   void Set(uint8_t Register, uint16_t Value);
+  void Set(const uint16_t* Values, uint8_t Count);
   void Set(bool force = false);
-  void Get(void);
+  void Flush(bool force);
+  void Trigger(void);
+public:
+  /* Groups of status fields, see Subscribe().
+   *   TuneStatus  : TuneComplete(), SeekFail(), ChannelNumber()
+   *   SignalStatus: SignalStrength(), IsStation(), StereoIndicator(), FM_ready()
+   *   RDSStatus   : RDS_ready() and all other RDS getters.
+   */
+  enum StatusGroup { TuneStatus, SignalStatus, RDSStatus };
+
+private:
+  void Get(StatusGroup Group);
   uint16_t Get(uint8_t Register);
+  unsigned long MaxAge(StatusGroup Group) const;
+public:
+  /* Bus cost of the last register commit in Set(), in SCL clock cycles
+   * (10us each at 100kHz), for both write strategies:
+   *   Random: one transaction to 0x11 per changed register
+   *   Burst : one sequential transaction to 0x10, starting at 0x02
+   * The cheaper one is used, unless the burst would rewrite an unchanged
+   * register holding a self clearing bit (SEEK, TUNE, SOFT_RESET, RDS_FIFO_CLR).
+   */
+  struct CommitCost {
+    uint16_t Random;
+    uint16_t Burst;
+    bool     UsedBurst;
+  };
+  CommitCost LastCommit(void) const { return lastCommit; }
+
+  /* Batched configuration.
+   * Between BeginBatch() and EndBatch(), setters only stage their changes;
+   * the final register image is written once, either by Commit() or when
+   * the outermost EndBatch() is reached. Batches may be nested.
+   * Actions are never deferred: SoftReset(), Seek(true), Tune(true),
+   * TuneAsync() and SeekAsync() write all changes staged so far at once.
+   *
+   * The Batch class does the same as RAII guard:
+   *   {
+   *   RDA5807M::Batch batch(radio);
+   *   radio.Band(0);
+   *   radio.Volume(8);
+   *   ...
+   *   } // committed here
+   */
+  void BeginBatch(void);
+  void EndBatch(void);
+  void Commit(void);
+
+  class Batch {
+  private:
+    RDA5807M_Driver& radio;
+  public:
+    Batch(RDA5807M_Driver& Radio) : radio(Radio) { radio.BeginBatch(); }
+    ~Batch() { radio.EndBatch(); }
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+    void Commit(void) { radio.Commit(); }
+  };
+
+private:
+  CommitCost lastCommit;
+  uint8_t batch;
+  bool staged;
+  bool forced;
+
 public:
   /* constructor.
-   * Before calling, the Wire library needs to be initialized.
+   * No bus access is done here, so the driver may be constructed
+   * statically before the Wire library is initialized.
+   */
+  RDA5807M_Driver(const Transport& Bus = Transport());
+
+  /* Fast boot.
+   * Writes a complete register image (see RDA5807M_PowerUpImage()) in one
+   * sequential burst and polls FM_READY and STC until the chip is tuned,
+   * instead of waiting fixed delays.
+   * Returns false, if the chip was not ready within Timeout ms.
+   * BootTime() is the time in ms from the write until ready.
+   */
+  bool Begin(const RDA5807M_Image& Image, unsigned long Timeout = 1000);
+  unsigned long BootTime(void) const { return bootTime; }
+
+  /* Warm attach, ie. after a reboot of the µC while the chip stayed powered.
+   * Reads 0x02..0x08 back from the chip in one transaction into the
+   * driver's register shadow, without writing anything. Afterwards only
+   * real changes are written, so audio and station are kept. The STC and
+   * RDS interrupts stay as they are; GPIO2 returns to high impedance, when
+   * they are turned off.
+   * 20 bytes on the bus, 1.9ms at 100kHz; below 1ms needs 400kHz I2C.
+   * Returns false on bus errors or if the chip is not powered up; use
+   * Begin() or PowerUp() then.
+   */
+  bool Attach(void);
+
+  /* access to the underlying transport.
    */
-  RDA5807M();
+  Transport& Bus(void) { return bus; }
 
   /* The Chip ID should read as 0x58xx, ie. 0x5804.
+   * Read from the chip on first call.
    */
   unsigned ChipId(void);
 
@@ -226,6 +303,42 @@ public:
   void Volume(int Value);
 
 
+  /* Status snapshot.
+   * ReadStatus() reads 0x0A..0x0F in one transaction, regardless of the
+   * read throttle of the single getters below, and returns all fields of
+   * this read together with it's time and sequence number.
+   * LastStatus() returns the most recent read without bus access; after a
+   * short read (see Poll()) the RDS words may be older than Time.
+   */
+  typedef RDA5807M_Status Status;
+  Status ReadStatus(void);
+  Status LastStatus(void) const;
+
+  /* Same as ReadStatus(), but reads only the words of Group, ie. 4 bytes
+   * for SignalStatus.
+   */
+  Status ReadStatus(StatusGroup Group);
+
+  /* Polling schedule.
+   * Without subscriptions, the getters read the chip at most every 500ms.
+   * A subscription declares how old (in ms) the fields of a group may be,
+   * ie.
+   *   Subscribe(RDSStatus, 87);     // every RDS group (11.4 groups/s)
+   *   Subscribe(SignalStatus, 1000);
+   *   Subscribe(TuneStatus, 10);
+   * MaxAge 0 removes a subscription. The TuneStatus subscription is only
+   * active from Tune(true) or Seek(true) until STC is read as set.
+   *
+   * Poll() reads the chip once, if the most demanding active subscription
+   * is due; call it from the main loop. Returns true, if a read was done.
+   *
+   * Reads are as short as the requested group allows: 2 bytes (0x0A) for
+   * TuneStatus, 4 bytes (0x0A..0x0B) for SignalStatus and all 12 bytes
+   * only for RDSStatus.
+   */
+  void Subscribe(StatusGroup Group, unsigned long MaxAge);
+  bool Poll(void);
+
   /* Stereo Indicator.
    * false = Mono
    * true  = Stereo
@@ -284,6 +397,21 @@ public:
    */
   void Tune(bool On);
 
+  /* Limits of the current Band() in kHz, ChannelSpacing() in kHz,
+   * the number of channels (max. 1024, CHAN is 10 bit) and the
+   * Frequency of a channel number in kHz. No bus access.
+   */
+  uint32_t BandStart(void) const;
+  uint32_t BandEnd(void) const;
+  uint16_t Spacing(void) const;
+  uint16_t Channels(void) const;
+  uint32_t Frequency(uint16_t Channel) const;
+
+  /* Channel last tuned to, from the register shadow: CHAN, updated to
+   * READCHAN once a tune or seek completed. No bus access.
+   */
+  uint16_t Channel(void) const { return Field(RDA5807M_Reg::CHAN); }
+
   /* True, if a seek or tune operation completed.
    * false = Not complete
    * true  = Complete
@@ -368,6 +496,57 @@ public:
    */
   bool RDS_BlockE(void);
 
+  /* RDS ready Interrupt Enable.
+   * Generate a low pulse on GPIO2, when a new group is ready.
+   * Sets GPIO2 to interrupt output, see Capture(). Switched off, GPIO2
+   * returns to it's previous mode, unless AsyncInterrupt() is still on.
+   */
+  void RDS_Interrupt(bool On);
+
+  /* RDS capture into a lock-free queue, ie.
+   *   RDA5807M_Ring<RDA5807M_Group, 16> queue;
+   * After Interrupt() was called from the GPIO2 edge, or without interrupts
+   * once the RDSStatus subscription (or 500ms) is due, 0x0A..0x0F are read
+   * in one burst; a new group is pushed with it's BLERA/BLERB, channel and
+   * timestamp. Capture() is the producer side of the queue and may run in
+   * a different context than the consumer (ie. a thread waiting on GPIO2),
+   * but must not run concurrently to other calls of this driver.
+   * A pending TuneAsync()/SeekAsync() is completed here as well, as STC and
+   * RDS share GPIO2.
+   * Returns the number of groups pushed.
+   */
+  template<class Queue>
+  uint8_t Capture(Queue& Q);
+
+  /* Reads the RDS window now and pushes a new group into Q.
+   * In RDS fifo mode, the window is read again while RDSR stays set,
+   * so that all queued groups (max. RDSDrainMax) are fetched in one
+   * visit. Capture() drains as well, once it's due.
+   * Returns the number of groups pushed.
+   */
+  template<class Queue>
+  uint8_t Drain(Queue& Q);
+
+  /* Estimated number of groups lost by fifo overflow, derived from the
+   * time RDS was synchronized between two visits finding the fifo empty
+   * and the RDS group rate of 1187.5bps / 104bit.
+   */
+  uint32_t RDS_Lost(void) const { return rdsLost; }
+
+  static constexpr uint8_t RDSDrainMax = 32;
+
+
+  //---------------------------------------------------
+  // recording
+  //---------------------------------------------------
+
+  /* Hook is called after every status read with the status, the number of
+   * words read and register 0x03 (CHAN, BAND and SPACE), ie. to write a
+   * capture (see RDA5807M_Capture.h). 0 = off.
+   */
+  typedef void (*Recorder)(void* Context, const Status& S, uint8_t Words, uint16_t Reg03);
+  void Record(Recorder Hook, void* Context = 0) { recorder = Hook; recordContext = Context; }
+
   /* Returns true, if RDS is US-style RDS (RDBS).
    * false = block id of registers 0x0C..0x0F is A,B,C,D 
    * true  = block id of registers 0x0C..0x0F is E
@@ -388,7 +567,8 @@ public:
 
   /* Returns RDS Block A..D (in RDS mode) or
    * Block E (in RBDS mode, RDS_is_RDBS() is true).
-   * Error Handling and Decoding needs to be done in user space.
+   * Error Handling and Decoding needs to be done in user space,
+   * ie. by RDA5807M_RDS.
    */
   uint16_t RDS_BlockA(void);
   uint16_t RDS_BlockB(void);
@@ -499,6 +679,8 @@ public:
    *      GPIO1: do not use.
    *   2: high
    *   3: low
+   * While AsyncInterrupt() or RDS_Interrupt() is on, GPIO2 is the interrupt
+   * output; a mode set meanwhile is applied once both are off.
    */
   void SetGPIO(int GPIO, int Choice);
 
@@ -518,4 +700,86 @@ public:
    */
   void InterruptMode(bool Wait);
 
+  //---------------------------------------------------
+  // Asynchronous tune/seek
+  //---------------------------------------------------
+
+  /* Called with the status read at STC, Context as given to TuneAsync()
+   * or SeekAsync().
+   */
+  typedef void (*TuneCallback)(void* Context, const Status& Result);
+
+  /* Use the STC interrupt on GPIO2 to complete asynchronous tune/seek.
+   * Sets GPIO2 to interrupt output and enables SeekTuneInterrupt().
+   * The GPIO2 falling edge has to call Interrupt().
+   * Without, or if an edge gets lost, Service() polls STC.
+   * Switched off, GPIO2 returns to it's previous mode (see SetGPIO()).
+   */
+  void AsyncInterrupt(bool On);
+
+  /* Start a tune to Channel or a seek, and return immediately.
+   * Done is called from Service() once STC is set.
+   * Returns false, if another tune/seek is still pending.
+   */
+  bool TuneAsync(uint16_t Channel, TuneCallback Done, void* Context = 0);
+  bool SeekAsync(bool Up, TuneCallback Done, void* Context = 0);
+
+  /* Register 0x03 image (CHAN, TUNE, BAND, SPACE) of a tune to Channel of
+   * the current Band() and ChannelSpacing(), ie. for a preset table.
+   * No bus access.
+   */
+  uint16_t ChannelWord(uint16_t Channel) const;
+
+  /* TuneAsync() with a precomputed 0x03 image: exactly one random write of
+   * 3 bytes to 0x11. Band and spacing follow the image. Never deferred.
+   */
+  bool ZapAsync(uint16_t Word, TuneCallback Done, void* Context = 0);
+
+  /* true, while an asynchronous tune/seek is pending. */
+  bool Busy(void) const { return asyncDone != 0; }
+
+  /* To be called from the GPIO2 interrupt handler (or the Linux GPIO
+   * event loop). Only sets a flag, no bus access.
+   */
+  void Interrupt(void) { irq = true; }
+
+  /* To be called from the main loop. Reads STC after an interrupt, or
+   * polled: a seek every AsyncPollTime ms, a tune every ms from
+   * AsyncTuneTime ms after it's start on (AsyncFallbackTime ms in
+   * interrupt mode), and calls the pending callback once complete.
+   * Returns true, if a tune/seek completed.
+   */
+  bool Service(void);
+
+  static constexpr unsigned long AsyncPollTime     = 5;
+  static constexpr unsigned long AsyncTuneTime     = 10; // typ. tune time
+  static constexpr unsigned long AsyncFallbackTime = 100;
+
+private:
+  bool Complete(void);
+  void Started(bool On);
+  volatile bool irq;
+  bool useIrq;
+  unsigned long startedAt; // ms, of the last tune/seek
+  uint8_t gpio2;    // GPIO2 mode, while it's the interrupt output
+  void InterruptPin(bool On);
+  TuneCallback asyncDone;
+  void* asyncContext;
+  void Account(uint8_t Groups);
+  unsigned long rdsEmptyAt;
+  uint16_t rdsPhase;
+  int8_t rdsBalance;
+  uint32_t rdsLost;
+  Recorder recorder;
+  void* recordContext;
 };
+
+#include "RDA5807M_impl.h"
+
+#ifdef ARDUINO
+#include "RDA5807M_Wire.h"
+extern template class RDA5807M_Driver<RDA5807M_Wire>;
+typedef RDA5807M_Driver<RDA5807M_Wire> RDA5807M;
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_CAPTURE_H
+#define RDA5807M_CAPTURE_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include <stddef.h> // size_t
+#include <string.h>
+#include "RDA5807M_Status.h"
+#include "RDA5807M_Reg.h"
+
+/*******************************************************************************
+ * Capture format of status reads, see RDA5807M_Driver::Record().
+ *
+ * An append-only file of a 16 byte header followed by fixed size records,
+ * all little endian:
+ *
+ *  header   0  char[8]  "RDA5807M"
+ *           8  uint16   Version
+ *          10  uint16   HeaderSize
+ *          12  uint16   RecordSize
+ *          14  uint16   0, reserved
+ *
+ *  record   0  uint32   Time, ms (Transport::Millis())
+ *           4  uint16   Rd[6], registers 0x0A..0x0F
+ *          16  uint16   register 0x03, CHAN, BAND and SPACE
+ *          18  uint8    Words read (1..6), Rd[Words..5] are older values
+ *          19  uint8    0, reserved
+ *
+ * Check() rejects versions it doesn't know. Readers skip header and record
+ * tails beyond the sizes they know, so that later versions may append
+ * fields. Records are in time order, so the file is seekable by time.
+ ******************************************************************************/
+namespace RDA5807M_Capture {
+  constexpr uint16_t Version    = 1;
+  constexpr uint16_t HeaderSize = 16;
+  constexpr uint16_t RecordSize = 20;
+
+  struct Record {
+    uint32_t Time;
+    uint16_t Rd[6];
+    uint16_t Tune;
+    uint8_t  Words;
+  };
+
+  inline void Put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+  inline uint16_t Get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+  inline void Header(uint8_t* Out) {
+    memcpy(Out, "RDA5807M", 8);
+    Put16(Out +  8, Version);
+    Put16(Out + 10, HeaderSize);
+    Put16(Out + 12, RecordSize);
+    Put16(Out + 14, 0);
+  }
+
+  /* returns the record size, 0 if not a capture of a known version. */
+  inline uint16_t Check(const uint8_t* Data, size_t Size) {
+    if ((Size < HeaderSize) or memcmp(Data, "RDA5807M", 8) or
+        (Get16(Data + 8) < 1) or (Get16(Data + 8) > Version) or
+        (Get16(Data + 10) < HeaderSize) or (Get16(Data + 12) < RecordSize))
+       return 0;
+    return Get16(Data + 12);
+  }
+
+  inline Record Make(const RDA5807M_Status& S, uint8_t Words, uint16_t Reg03) {
+    using namespace RDA5807M_Reg;
+    Record r;
+    r.Time = S.Time;
+    for(int i=0; i<6; i++)
+       r.Rd[i] = S.Rd[i];
+    r.Tune  = Reg03 & (CHAN.Mask() | BAND.Mask() | SPACE.Mask());
+    r.Words = Words;
+    return r;
+  }
+
+  inline void Encode(const Record& R, uint8_t* Out) {
+    Put16(Out, R.Time);
+    Put16(Out + 2, R.Time >> 16);
+    for(int i=0; i<6; i++)
+       Put16(Out + 4 + 2 * i, R.Rd[i]);
+    Put16(Out + 16, R.Tune);
+    Out[18] = R.Words;
+    Out[19] = 0;
+  }
+
+  inline void Decode(const uint8_t* In, Record& R) {
+    R.Time = Get16(In) | ((uint32_t) Get16(In + 2) << 16);
+    for(int i=0; i<6; i++)
+       R.Rd[i] = Get16(In + 4 + 2 * i);
+    R.Tune  = Get16(In + 16);
+    R.Words = In[18];
+  }
+}
+
+
+/*******************************************************************************
+ * Transport replaying a capture (ie. mapped by RDA5807M_LinuxCapture) to an
+ * unmodified driver, without hardware:
+ *   RDA5807M_Replay replay(data, size);
+ *   RDA5807M_Driver<RDA5807M_Replay> radio(replay);
+ *   radio.Attach(); // reads the first record
+ *
+ * Every status read returns the next record. The replay clock runs at the
+ * time of the next record, so that a driver reading as often as the
+ * recorded one sees the recorded times. Every Millis() call beyond that
+ * adds PollTime us, so that a driver, which serves it's getters from cached
+ * status, still gets to it's next read. Writes are accepted and ignored;
+ * random reads of 0x02..0x08 return the defaults with ENABLE and RDS, and
+ * 0x03 of the next record.
+ ******************************************************************************/
+class RDA5807M_Replay {
+private:
+  const uint8_t* data;
+  uint32_t count;
+  uint32_t next;
+  uint16_t size;
+  uint64_t now;   // us
+
+  RDA5807M_Capture::Record Next(void) const {
+    RDA5807M_Capture::Record r;
+    memset(&r, 0, sizeof(r));
+    uint32_t i = (next < count) ? next : count - 1;
+    if (count)
+       RDA5807M_Capture::Decode(data + RDA5807M_Capture::Get16(data + 10) + i * size, r);
+    return r;
+  }
+
+public:
+  RDA5807M_Replay(const uint8_t* Data = 0, size_t Size = 0) :
+    data(Data), count(0), next(0), size(0), now(0), PollTime(10) {
+    if (Data and (size = RDA5807M_Capture::Check(Data, Size)))
+       count = (Size - RDA5807M_Capture::Get16(Data + 10)) / size;
+  }
+
+  /* us added on every Millis() call, once the time of the next record is
+   * reached.
+   */
+  uint32_t PollTime;
+
+  uint32_t Records(void) const { return count; }
+  uint32_t Position(void) const { return next; }
+  bool End(void) const { return next >= count; }
+
+  RDA5807M_Capture::Record At(uint32_t Index) {
+    uint32_t n = next;
+    next = Index;
+    RDA5807M_Capture::Record r = Next();
+    next = n;
+    return r;
+  }
+
+  /* continue with the first record at or after Time, binary search. */
+  void Seek(unsigned long Time) {
+    uint32_t lo = 0, hi = count;
+    while(lo < hi) {
+       uint32_t mid = lo + (hi - lo) / 2;
+       if (At(mid).Time < Time)
+          lo = mid + 1;
+       else
+          hi = mid;
+       }
+    next = lo;
+    now  = Time * 1000ULL;
+  }
+
+  /* moves the replay clock forward. */
+  void Advance(uint32_t Microseconds) { now += Microseconds; }
+
+  bool Write(uint8_t, const uint8_t*, uint8_t) { return count > 0; }
+
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    if ((Address != 0x10) or End())
+       return false;
+    RDA5807M_Capture::Record r = Next();
+    next++;
+    if (now < r.Time * 1000ULL)
+       now = r.Time * 1000ULL;
+    for(uint8_t i=0; i+1 < Count and i < 12; i+=2) {
+       Data[i]   = r.Rd[i/2] >> 8;
+       Data[i+1] = r.Rd[i/2];
+       }
+    return true;
+  }
+
+  bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+                 uint8_t* In, uint8_t InCount) {
+    using namespace RDA5807M_Reg;
+    if ((Address != 0x11) or (OutCount < 1) or not count)
+       return false;
+    uint8_t reg = Out[0];
+    for(uint8_t i=0; i+1 < InCount; i+=2, reg = (reg + 1) & 0x0F) {
+       uint16_t v = 0;
+       if (reg == 0x00)
+          v = 0x5804;
+       else if (reg == 0x02)
+          v = With(With(Defaults[0], ENABLE, 1), RDS_EN, 1);
+       else if (reg == 0x03)
+          v = Next().Tune;
+       else if ((reg > 0x03) and (reg <= 0x08))
+          v = Defaults[reg - 0x02];
+       else if (reg >= 0x0A)
+          v = Next().Rd[reg - 0x0A];
+       In[i]   = v >> 8;
+       In[i+1] = v;
+       }
+    return true;
+  }
+
+  unsigned long Millis(void) {
+    uint64_t due = Next().Time * 1000ULL;
+    if (now < due)
+       now = due;
+    else
+       now += PollTime;
+    return now / 1000;
+  }
+
+  unsigned long Micros(void) { return now; }
+  void Print(const char*) {}
+};
+
+#endif
@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#include <stddef.h>
+#include "RDA5807M_Columns.h"
+
+#if RDA5807M_SIMD and (defined(__AVX2__) or defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+/*******************************************************************************
+ * Records are decoded in blocks of Lanes: the status words 0x0A and 0x0B are
+ * gathered from the records, the fields derived from them with vector ops.
+ * With AVX2, the gather is vectorised as well: 8 records at a time, each
+ * 32 bit gather loads the time, the status words or two RDS blocks of all 8.
+ ******************************************************************************/
+static constexpr uint8_t Lanes = 16;
+
+static inline uint16_t Word(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static void Scalar(const uint16_t* W0, const uint16_t* W1, uint8_t n,
+                   const RDA5807M_Columns& Out, uint32_t Base) {
+  for(uint8_t i=0; i<n; i++) {
+     uint16_t a = W0[i], b = W1[i];
+     if (Out.Channel) Out.Channel[Base + i] = a & 0x3FF;
+     if (Out.Rssi)    Out.Rssi[Base + i]    = b >> 9;
+     if (Out.Flags)   Out.Flags[Base + i]   = (a >> 10) | ((b >> 2) & 0x40) | (b & 0x80);
+     if (Out.BlerA)   Out.BlerA[Base + i]   = (b >> 2) & 3;
+     if (Out.BlerB)   Out.BlerB[Base + i]   = b & 3;
+     }
+}
+
+#if RDA5807M_SIMD and defined(__AVX2__)
+static constexpr uint8_t Gathers = 8;
+
+// 8 x 32 bit, each below 0x10000, to 8 x 16 bit.
+static inline __m128i Narrow(__m256i v) {
+  // packus works per 128 bit lane, bring the two halves together.
+  __m256i packed = _mm256_packus_epi32(v, _mm256_setzero_si256());
+  return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0xD8));
+}
+
+static inline void Store16(uint16_t* p, __m256i v) {
+  _mm_storeu_si128((__m128i*) p, Narrow(v));
+}
+
+static inline void Store8(uint8_t* p, __m256i v) {
+  _mm_storel_epi64((__m128i*) p, _mm_packus_epi16(Narrow(v), _mm_setzero_si128()));
+}
+
+static inline __m256i Gather(const uint8_t* p, __m256i Index) {
+  return _mm256_i32gather_epi32((const int*) p, Index, 1);
+}
+
+// the records Base..Base+7, starting at p.
+static void Gathered(const uint8_t* p, __m256i Index, const RDA5807M_Columns& Out, uint32_t Base) {
+  if (Out.Time)
+     _mm256_storeu_si256((__m256i*) (Out.Time + Base), Gather(p, Index));
+
+  // word 0x0A in the low, 0x0B in the high half.
+  __m256i w = Gather(p + 4, Index);
+  __m256i three = _mm256_set1_epi32(3);
+  if (Out.Channel)
+     Store16(Out.Channel + Base, _mm256_and_si256(w, _mm256_set1_epi32(0x3FF)));
+  if (Out.Rssi)
+     Store8(Out.Rssi + Base, _mm256_srli_epi32(w, 25));
+  if (Out.Flags)
+     Store8(Out.Flags + Base, _mm256_or_si256(
+        _mm256_and_si256(_mm256_srli_epi32(w, 10), _mm256_set1_epi32(0x3F)),
+        _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(w, 18), _mm256_set1_epi32(0x40)),
+                        _mm256_and_si256(_mm256_srli_epi32(w, 16), _mm256_set1_epi32(0x80)))));
+  if (Out.BlerA)
+     Store8(Out.BlerA + Base, _mm256_and_si256(_mm256_srli_epi32(w, 18), three));
+  if (Out.BlerB)
+     Store8(Out.BlerB + Base, _mm256_and_si256(_mm256_srli_epi32(w, 16), three));
+
+  for(int b=0; b<4; b+=2) {
+     if (not Out.Block[b] and not Out.Block[b + 1])
+        continue;
+     __m256i blocks = Gather(p + 8 + 2 * b, Index);
+     if (Out.Block[b])
+        Store16(Out.Block[b] + Base, _mm256_and_si256(blocks, _mm256_set1_epi32(0xFFFF)));
+     if (Out.Block[b + 1])
+        Store16(Out.Block[b + 1] + Base, _mm256_srli_epi32(blocks, 16));
+     }
+}
+#endif
+
+#if RDA5807M_SIMD and defined(__SSE2__) and not defined(__AVX2__)
+static inline void Store8(uint8_t* p, __m128i v) {
+  _mm_storel_epi64((__m128i*) p, _mm_packus_epi16(v, _mm_setzero_si128()));
+}
+
+static void Vector(const uint16_t* W0, const uint16_t* W1,
+                   const RDA5807M_Columns& Out, uint32_t Base) {
+  __m128i three = _mm_set1_epi16(3);
+  for(uint8_t i=0; i<Lanes; i+=8) {
+     __m128i a = _mm_loadu_si128((const __m128i*) (W0 + i));
+     __m128i b = _mm_loadu_si128((const __m128i*) (W1 + i));
+     uint32_t n = Base + i;
+     if (Out.Channel)
+        _mm_storeu_si128((__m128i*) (Out.Channel + n), _mm_and_si128(a, _mm_set1_epi16(0x3FF)));
+     if (Out.Rssi)
+        Store8(Out.Rssi + n, _mm_srli_epi16(b, 9));
+     if (Out.Flags)
+        Store8(Out.Flags + n, _mm_or_si128(_mm_srli_epi16(a, 10),
+           _mm_or_si128(_mm_and_si128(_mm_srli_epi16(b, 2), _mm_set1_epi16(0x40)),
+                        _mm_and_si128(b, _mm_set1_epi16(0x80)))));
+     if (Out.BlerA)
+        Store8(Out.BlerA + n, _mm_and_si128(_mm_srli_epi16(b, 2), three));
+     if (Out.BlerB)
+        Store8(Out.BlerB + n, _mm_and_si128(b, three));
+     }
+}
+#else
+static void Vector(const uint16_t* W0, const uint16_t* W1,
+                   const RDA5807M_Columns& Out, uint32_t Base) {
+  Scalar(W0, W1, Lanes, Out, Base);
+}
+#endif
+
+void RDA5807M_Decode(const uint8_t* Records, uint32_t Count, uint16_t Stride,
+                     const RDA5807M_Columns& Out) {
+  uint16_t w0[Lanes], w1[Lanes];
+  uint32_t first = 0;
+
+#if RDA5807M_SIMD and defined(__AVX2__)
+  __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                     _mm256_set1_epi32(Stride));
+  for(; Count - first >= Gathers; first += Gathers)
+     Gathered(Records + (size_t) first * Stride, index, Out, first);
+#endif
+
+  for(uint32_t base=first; base<Count; base+=Lanes) {
+     uint8_t n = (Count - base < Lanes) ? Count - base : Lanes;
+     const uint8_t* p = Records + (size_t) base * Stride;
+     for(uint8_t i=0; i<n; i++, p+=Stride) {
+        // record: Time, Rd[6], see RDA5807M_Capture.h
+        w0[i] = Word(p + 4);
+        w1[i] = Word(p + 6);
+        if (Out.Time)
+           Out.Time[base + i] = Word(p) | ((uint32_t) Word(p + 2) << 16);
+        for(int b=0; b<4; b++)
+           if (Out.Block[b])
+              Out.Block[b][base + i] = Word(p + 8 + 2 * b);
+        }
+     if (n == Lanes)
+        Vector(w0, w1, Out, base);
+     else
+        Scalar(w0, w1, n, Out, base);
+     }
+}
+
+#ifdef __linux__
+struct Job {
+  const uint8_t* Records;
+  uint32_t Count;
+  uint16_t Stride;
+  RDA5807M_Columns Out;
+};
+
+static void* Worker(void* Arg) {
+  Job* j = (Job*) Arg;
+  RDA5807M_Decode(j->Records, j->Count, j->Stride, j->Out);
+  return 0;
+}
+
+static void Offset(RDA5807M_Columns& C, uint32_t n) {
+  if (C.Time)    C.Time    += n;
+  if (C.Channel) C.Channel += n;
+  if (C.Rssi)    C.Rssi    += n;
+  if (C.Flags)   C.Flags   += n;
+  if (C.BlerA)   C.BlerA   += n;
+  if (C.BlerB)   C.BlerB   += n;
+  for(int b=0; b<4; b++)
+     if (C.Block[b]) C.Block[b] += n;
+}
+
+void RDA5807M_DecodeParallel(const uint8_t* Records, uint32_t Count, uint16_t Stride,
+                             const RDA5807M_Columns& Out, unsigned Threads) {
+  static constexpr unsigned MaxThreads = 64;
+  if (Threads > MaxThreads) Threads = MaxThreads;
+  if (Threads < 2 or Count < Threads * Lanes) {
+     RDA5807M_Decode(Records, Count, Stride, Out);
+     return;
+     }
+
+  Job jobs[MaxThreads];
+  pthread_t tid[MaxThreads];
+  bool started[MaxThreads];
+  // ranges are multiples of Lanes, the last one takes the rest.
+  uint32_t chunk = (Count / Threads) / Lanes * Lanes;
+  for(unsigned t=0; t<Threads; t++) {
+     uint32_t first = t * chunk;
+     jobs[t].Records = Records + (size_t) first * Stride;
+     jobs[t].Count   = (t == Threads - 1) ? Count - first : chunk;
+     jobs[t].Stride  = Stride;
+     jobs[t].Out     = Out;
+     Offset(jobs[t].Out, first);
+     started[t] = (t > 0) and (pthread_create(&tid[t], 0, Worker, &jobs[t]) == 0);
+     }
+  for(unsigned t=0; t<Threads; t++)
+     if (not started[t])
+        Worker(&jobs[t]);
+  for(unsigned t=1; t<Threads; t++)
+     if (started[t])
+        pthread_join(tid[t], 0);
+}
+#endif
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_COLUMNS_H
+#define RDA5807M_COLUMNS_H
+
+#include <stdint.h> // uint{8,16,32}_t
+
+/*******************************************************************************
+ * Compile time switch, to be given as compiler flag (ie. -DRDA5807M_SIMD=0)
+ *
+ *   RDA5807M_SIMD  1: use AVX2 or SSE2, if the compiler targets them
+ *                     (ie. -mavx2). Default 1.
+ *                  0: scalar code only.
+ ******************************************************************************/
+#ifndef RDA5807M_SIMD
+#define RDA5807M_SIMD 1
+#endif
+
+
+/*******************************************************************************
+ * Columns (struct of arrays) decoded from status records. Each column holds
+ * one entry per record; columns given as 0 are skipped. The values are the
+ * same as of the driver's getters, ie. RSSI as SignalStrength().
+ ******************************************************************************/
+struct RDA5807M_Columns {
+  enum {
+    Stereo       = 0x01,  // StereoIndicator()
+    BlockE       = 0x02,  // RDS_BlockE()
+    RDSSync      = 0x04,  // RDS_sync()
+    SeekFail     = 0x08,  // SeekFail()
+    TuneComplete = 0x10,  // TuneComplete()
+    RDSReady     = 0x20,  // RDS_ready()
+    FMTrue       = 0x40,  // IsStation()
+    FMReady      = 0x80,  // FM_ready()
+  };
+
+  uint32_t* Time;      // ms
+  uint16_t* Channel;   // ChannelNumber(), READCHAN
+  uint8_t*  Rssi;      // SignalStrength()
+  uint8_t*  Flags;     // see above
+  uint8_t*  BlerA;     // RDS_BlockErrors_A()
+  uint8_t*  BlerB;     // RDS_BlockErrors_B()
+  uint16_t* Block[4];  // RDS_BlockA() .. RDS_BlockD()
+};
+
+/* Decodes Count records of a capture (RDA5807M_Capture.h), starting at
+ * Records (the first record after the header) with Stride bytes each, to
+ * the entries 0..Count-1 of Out.
+ */
+void RDA5807M_Decode(const uint8_t* Records, uint32_t Count, uint16_t Stride,
+                     const RDA5807M_Columns& Out);
+
+#ifdef __linux__
+/* Same as RDA5807M_Decode(), split into Threads ranges, decoded in parallel.
+ * Needs -pthread.
+ */
+void RDA5807M_DecodeParallel(const uint8_t* Records, uint32_t Count, uint16_t Stride,
+                             const RDA5807M_Columns& Out, unsigned Threads);
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_EXPORT_H
+#define RDA5807M_EXPORT_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M_Status.h"
+
+/*******************************************************************************
+ * Streaming serializer of RDS groups, for external analysis tools.
+ *
+ * Hex    : one line per group, four blocks as hex, space separated, blocks
+ *          with uncorrectable errors as "----", ie.
+ *            D3C2 2001 4E44 5220
+ *          The chip reports errors of A and B only; as RDA5807M_RDS, blocks
+ *          C and D are taken as unusable with block B.
+ *          as read by redsea (-h) and RDS Spy. 20 bytes per group.
+ * Binary : fixed 16 byte records, little endian
+ *            0  uint32  Time, ms
+ *            4  uint16  Block A..D
+ *           12  uint8   BLERA << 2 | BLERB
+ *           13  uint16  Channel
+ *           15  uint8   0, reserved
+ *
+ * The serializer holds one record and no heap. It writes through a sink,
+ * which needs a
+ *   uint16_t Write(const uint8_t* Data, uint16_t Count);
+ * returning the number of bytes taken, possibly less than Count if it's
+ * buffer is full (ie. Serial.availableForWrite()). The rest of a record
+ * stays pending and is retried by Flush() or the next Put().
+ *
+ * 11.4 groups/s are 228 bytes/s in hex and 182 bytes/s binary, both fit a
+ * serial link of 2400 baud (240 bytes/s, 8N1).
+ ******************************************************************************/
+template<class Sink>
+class RDA5807M_Export {
+public:
+  enum Format { Hex, Binary };
+  static constexpr uint8_t RecordSize = 16;
+  static constexpr uint8_t LineSize   = 20;
+
+  RDA5807M_Export(const Sink& S = Sink(), Format F = Hex) :
+    Records(0), Stalls(0), sink(S), format(F), size(0), done(0) {}
+
+  /* Serializes G. Returns false, if the sink is still behind with the
+   * previous record; G is not taken then, back-pressure to the caller:
+   *   while(exporter.Flush() and queue.Pop(g))
+   *      exporter.Put(g);
+   */
+  bool Put(const RDA5807M_Group& G) {
+    if (not Flush()) {
+       Stalls++;
+       return false;
+       }
+    size = Encode(G, format, buffer);
+    done = 0;
+    Records++;
+    Flush();
+    return true;
+  }
+
+  /* Writes pending bytes. Returns true, if nothing is pending anymore. */
+  bool Flush(void) {
+    if (done < size)
+       done += sink.Write(buffer + done, size - done);
+    return done >= size;
+  }
+
+  /* bytes of the current record not yet taken by the sink. */
+  uint8_t Pending(void) const { return size - done; }
+
+  /* Encodes G to Out, which holds LineSize bytes. Returns the length. */
+  static uint8_t Encode(const RDA5807M_Group& G, Format F, uint8_t* Out) {
+    if (F == Binary) {
+       Put32(Out, G.Time);
+       for(int i=0; i<4; i++)
+          Put16(Out + 4 + 2 * i, G.Block[i]);
+       Out[12] = (G.BLERA & 3) << 2 | (G.BLERB & 3);
+       Put16(Out + 13, G.Channel);
+       Out[15] = 0;
+       return RecordSize;
+       }
+
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t* p = Out;
+    for(int i=0; i<4; i++) {
+       uint8_t errors = (i == 0) ? G.BLERA : G.BLERB;
+       for(int n=12; n>=0; n-=4)
+          *p++ = (errors > 2) ? '-' : hex[(G.Block[i] >> n) & 15];
+       *p++ = (i < 3) ? ' ' : '\n';
+       }
+    return LineSize;
+  }
+
+  Sink& Output(void) { return sink; }
+
+  /* statistics */
+  uint32_t Records;   // groups taken
+  uint32_t Stalls;    // Put() refused, as the sink was behind
+
+private:
+  Sink sink;
+  Format format;
+  uint8_t buffer[LineSize];
+  uint8_t size;
+  uint8_t done;
+
+  static void Put16(uint8_t* p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+  }
+
+  static void Put32(uint8_t* p, uint32_t v) {
+    Put16(p, v);
+    Put16(p + 2, v >> 16);
+  }
+};
+
+#endif
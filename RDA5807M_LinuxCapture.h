@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_LINUXCAPTURE_H
+#define RDA5807M_LINUXCAPTURE_H
+
+#ifdef __linux__
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RDA5807M_Capture.h"
+
+/*******************************************************************************
+ * Capture files on Linux hosts.
+ *
+ * Recording, every status read of the driver is appended:
+ *   RDA5807M_LinuxCapture file;
+ *   file.Create("session.cap");
+ *   radio.Record(RDA5807M_LinuxCapture::Recorder, &file);
+ *
+ * Replay, the file is mapped read only and given to RDA5807M_Replay:
+ *   file.Map("session.cap");
+ *   RDA5807M_Replay replay(file.Data(), file.Size());
+ ******************************************************************************/
+class RDA5807M_LinuxCapture {
+private:
+  FILE* file;
+  const uint8_t* data;
+  size_t size;
+public:
+  RDA5807M_LinuxCapture(void) : file(0), data(0), size(0), Records(0) {}
+  ~RDA5807M_LinuxCapture() { Close(); }
+  RDA5807M_LinuxCapture(const RDA5807M_LinuxCapture&) = delete;
+  RDA5807M_LinuxCapture& operator=(const RDA5807M_LinuxCapture&) = delete;
+
+  /* records written */
+  uint32_t Records;
+
+  /* creates (or truncates) Path and writes the header. */
+  bool Create(const char* Path) {
+    Close();
+    file = fopen(Path, "wb");
+    if (not file)
+       return false;
+    uint8_t header[RDA5807M_Capture::HeaderSize];
+    RDA5807M_Capture::Header(header);
+    return fwrite(header, sizeof(header), 1, file) == 1;
+  }
+
+  bool Add(const RDA5807M_Capture::Record& R) {
+    uint8_t buf[RDA5807M_Capture::RecordSize];
+    RDA5807M_Capture::Encode(R, buf);
+    if (not file or (fwrite(buf, sizeof(buf), 1, file) != 1))
+       return false;
+    Records++;
+    return true;
+  }
+
+  /* RDA5807M_Driver::Record() hook, Context is the RDA5807M_LinuxCapture. */
+  static void Recorder(void* Context, const RDA5807M_Status& S, uint8_t Words, uint16_t Reg03) {
+    ((RDA5807M_LinuxCapture*) Context)->Add(RDA5807M_Capture::Make(S, Words, Reg03));
+  }
+
+  /* maps Path read only. */
+  bool Map(const char* Path) {
+    Close();
+    int fd = open(Path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+       return false;
+    struct stat st;
+    if ((fstat(fd, &st) == 0) and (st.st_size > 0)) {
+       void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+       if (p != MAP_FAILED) {
+          data = (const uint8_t*) p;
+          size = st.st_size;
+          }
+       }
+    close(fd);
+    return data != 0;
+  }
+
+  const uint8_t* Data(void) const { return data; }
+  size_t Size(void) const { return size; }
+
+  void Close(void) {
+    if (file)
+       fclose(file);
+    if (data)
+       munmap((void*) data, size);
+    file = 0;
+    data = 0;
+    size = 0;
+  }
+};
+
+#endif // __linux__
+#endif
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_LINUXGPIO_H
+#define RDA5807M_LINUXGPIO_H
+
+#ifdef __linux__
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/*******************************************************************************
+ * GPIO2 interrupt input on Linux hosts, using the GPIO character device
+ * (/dev/gpiochipN, uAPI v2). The line is requested with pull up for falling
+ * edges.
+ *
+ *   RDA5807M_LinuxGpio irq;
+ *   irq.Open(0, 17);
+ *   radio.AsyncInterrupt(true);
+ *   radio.TuneAsync(42, Done);
+ *   while(radio.Busy()) {
+ *      if (irq.Wait(10) > 0)
+ *         radio.Interrupt();
+ *      radio.Service();
+ *      }
+ ******************************************************************************/
+class RDA5807M_LinuxGpio {
+private:
+  int fd;
+public:
+  RDA5807M_LinuxGpio(void) : fd(-1) {}
+  ~RDA5807M_LinuxGpio() { Close(); }
+  RDA5807M_LinuxGpio(const RDA5807M_LinuxGpio&) = delete;
+  RDA5807M_LinuxGpio& operator=(const RDA5807M_LinuxGpio&) = delete;
+
+  /* Requests Line of /dev/gpiochip<Chip>. */
+  bool Open(int Chip, unsigned Line) {
+    char dev[24];
+    snprintf(dev, sizeof(dev), "/dev/gpiochip%d", Chip);
+    int chip = open(dev, O_RDWR | O_CLOEXEC);
+    if (chip < 0)
+       return false;
+
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    req.offsets[0]   = Line;
+    req.num_lines    = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT |
+                       GPIO_V2_LINE_FLAG_EDGE_FALLING |
+                       GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+    strncpy(req.consumer, "RDA5807M", sizeof(req.consumer) - 1);
+
+    Close();
+    if (ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &req) == 0)
+       fd = req.fd;
+    close(chip);
+    return fd >= 0;
+  }
+
+  void Close(void) {
+    if (fd >= 0)
+       close(fd);
+    fd = -1;
+  }
+
+  /* the line's file descriptor, ie. for an own poll() loop. */
+  int Fd(void) const { return fd; }
+
+  /* Waits up to Timeout ms for falling edges.
+   * Returns the number of edges, 0 on timeout or -1 on error.
+   */
+  int Wait(int Timeout) {
+    struct pollfd p;
+    p.fd = fd;
+    p.events = POLLIN;
+    p.revents = 0;
+    int r = poll(&p, 1, Timeout);
+    if (r <= 0)
+       return r;
+
+    struct gpio_v2_line_event events[16];
+    ssize_t n = read(fd, events, sizeof(events));
+    if (n < 0)
+       return -1;
+    return n / sizeof(events[0]);
+  }
+};
+
+#endif // __linux__
+#endif
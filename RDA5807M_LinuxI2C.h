@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_LINUXI2C_H
+#define RDA5807M_LINUXI2C_H
+
+#ifdef __linux__
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/*******************************************************************************
+ * Transport for RDA5807M_Driver on Linux hosts, using /dev/i2c-N.
+ *
+ * Every transaction is issued as one I2C_RDWR ioctl, so that a register read
+ * (index write + repeated start + read) as well as the 12 byte status/RDS
+ * window read costs exactly one syscall.
+ *
+ * The file descriptor is not owned by this class, as the driver keeps a copy
+ * of it's transport. Use Open() and Close() to manage it.
+ ******************************************************************************/
+class RDA5807M_LinuxI2C {
+private:
+  int fd;
+
+  bool Transfer(struct i2c_msg* Msgs, unsigned Count) {
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs  = Msgs;
+    data.nmsgs = Count;
+    return ioctl(fd, I2C_RDWR, &data) == (int) Count;
+  }
+public:
+  RDA5807M_LinuxI2C(int Fd = -1) : fd(Fd) {}
+
+  /* Opens /dev/i2c-<Adapter>, returns the file descriptor or -1.
+   */
+  static int Open(int Adapter) {
+    char dev[24];
+    snprintf(dev, sizeof(dev), "/dev/i2c-%d", Adapter);
+    return open(dev, O_RDWR | O_CLOEXEC);
+  }
+
+  static void Close(int Fd) {
+    if (Fd >= 0)
+       close(Fd);
+  }
+
+  int Fd(void) const { return fd; }
+
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+    struct i2c_msg msg;
+    msg.addr  = Address;
+    msg.flags = 0;
+    msg.len   = Count;
+    msg.buf   = const_cast<uint8_t*>(Data);
+    return Transfer(&msg, 1);
+  }
+
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    struct i2c_msg msg;
+    msg.addr  = Address;
+    msg.flags = I2C_M_RD;
+    msg.len   = Count;
+    msg.buf   = Data;
+    return Transfer(&msg, 1);
+  }
+
+  bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+                 uint8_t* In, uint8_t InCount) {
+    struct i2c_msg msgs[2];
+    msgs[0].addr  = Address;
+    msgs[0].flags = 0;
+    msgs[0].len   = OutCount;
+    msgs[0].buf   = const_cast<uint8_t*>(Out);
+    msgs[1].addr  = Address;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = InCount;
+    msgs[1].buf   = In;
+    return Transfer(msgs, 2);
+  }
+
+  unsigned long Millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL;
+  }
+
+  unsigned long Micros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000UL + ts.tv_nsec / 1000UL;
+  }
+
+  void Print(const char* s) {
+    fputs(s, stderr);
+  }
+};
+
+#endif // __linux__
+#endif
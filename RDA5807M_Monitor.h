@@ -0,0 +1,272 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_MONITOR_H
+#define RDA5807M_MONITOR_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M.h"
+#include "RDA5807M_Ring.h"
+
+/*******************************************************************************
+ * A change of a channel, see RDA5807M_Monitor::Diffs().
+ ******************************************************************************/
+struct RDA5807M_ChannelDiff {
+  uint16_t Channel;
+  uint8_t  Rssi;       // 0..127
+  bool     Occupied;
+  unsigned long Time;  // ms
+};
+
+
+/*******************************************************************************
+ * Continuous band occupancy monitor, a background mode on top of TuneAsync().
+ *
+ * The monitor keeps tuning the channels of the current Band() and
+ * ChannelSpacing() (max. MaxChannels). Each visit stores one byte
+ * (FM_TRUE << 7 | RSSI) in the current slot of a ring of Slots slots of
+ * SlotTime ms each, and updates a score per channel, which follows the
+ * station flag with the time t since the channel's last visit:
+ *   score += (target - score) * min(t, DecayTime) / DecayTime
+ * with target = 255 on FM_TRUE, else 0, and at least one step towards it
+ * while t > 0, in signed 32bit integers. So the score decays with time, not
+ * with the number of visits, and channels visited more often don't fall
+ * faster. A channel becomes occupied at a score of 128 and free below 64.
+ *
+ * Visits alternate between a sweep over all channels and a round robin over
+ * the hot channels (score > 0), so channels, which held a station recently,
+ * are revisited more often; changes are reported as diffs (occupied/free,
+ * RSSI changed by RssiDelta) through a queue of DiffQueue entries.
+ *
+ * The defaults need about 3KB of RAM (map and the last visit times), more
+ * than an AVR Uno has; use less MaxChannels and Slots there, or a larger
+ * board.
+ *
+ *   RDA5807M_Monitor<RDA5807M_Wire, 211, 8> monitor(radio);
+ *   monitor.Start();
+ *   loop: monitor.Step();
+ *         RDA5807M_ChannelDiff d;
+ *         while(monitor.Diffs().Pop(d)) ...
+ ******************************************************************************/
+template<class Transport, uint16_t MaxChannels = 211, uint8_t Slots = 8, uint8_t DiffQueue = 32>
+class RDA5807M_Monitor {
+public:
+  typedef RDA5807M_Driver<Transport> Driver;
+  typedef typename Driver::Status Status;
+  typedef RDA5807M_Ring<RDA5807M_ChannelDiff, DiffQueue> Queue;
+
+  RDA5807M_Monitor(Driver& Radio) : SlotTime(10000), DecayTime(1000), RssiDelta(6),
+    HotShare(1), Visits(0), HotVisits(0), radio(Radio), channels(0), sweep(0), hot(0), visits(0), channel(0), saved(0),
+    slot(0), slotStart(0), state(Idle) {
+    Clear();
+  }
+
+  /* ms per slot of the map */
+  unsigned long SlotTime;
+
+  /* ms until the score fully follows a change of the station flag */
+  unsigned long DecayTime;
+
+  /* min. RSSI change reported as diff */
+  uint8_t RssiDelta;
+
+  /* hot visits per sweep visit, 0 = sweep only */
+  uint8_t HotShare;
+
+  /* starts monitoring with an empty map and no pending diffs; false, if a
+   * tune/seek is pending.
+   */
+  bool Start(void) {
+    if ((state != Idle) or radio.Busy())
+       return false;
+    channels  = radio.Channels();
+    if (channels > MaxChannels)
+       channels = MaxChannels;
+    Clear();
+    RDA5807M_ChannelDiff d;
+    while(diffs.Pop(d));
+    sweep     = 0;
+    hot       = 0;
+    visits    = 0;
+    slot      = 0;
+    Visits    = 0;
+    HotVisits = 0;
+    saved     = radio.Channel();
+    slotStart = radio.Bus().Millis();
+    // not visited before: the first visit sets the score.
+    for(uint16_t c=0; c<MaxChannels; c++)
+       seen[c] = slotStart - DecayTime;
+    state     = Monitoring;
+    Visit(sweep);
+    return true;
+  }
+
+  /* stops after the current visit and tunes back. */
+  void Stop(void) {
+    if (state == Monitoring)
+       state = Stopping;
+  }
+
+  /* Advances the monitor. Returns true, while it's running. */
+  bool Step(void) {
+    if (state != Idle)
+       radio.Service();
+    return state != Idle;
+  }
+
+  /* map and score */
+  uint16_t Channels(void) const { return channels; }
+  uint8_t  Score(uint16_t Channel) const { return score[Channel]; }
+  bool     Occupied(uint16_t Channel) const { return (occupied[Channel / 8] >> (Channel % 8)) & 1; }
+  uint8_t  Rssi(uint16_t Channel) const { return rssi[Channel]; }
+
+  /* FM_TRUE << 7 | RSSI of Channel, SlotsAgo slots before the current one.
+   * 0 = not visited in that slot.
+   */
+  uint8_t Sample(uint16_t Channel, uint8_t SlotsAgo) const {
+    return map[(slot + Slots - SlotsAgo % Slots) % Slots][Channel];
+  }
+
+  /* pending diffs */
+  Queue& Diffs(void) { return diffs; }
+
+  /* statistics */
+  uint32_t Visits;
+  uint32_t HotVisits;
+
+private:
+  Driver&  radio;
+  uint8_t  map[Slots][MaxChannels];
+  uint8_t  score[MaxChannels];
+  uint8_t  rssi[MaxChannels];
+  uint8_t  occupied[(MaxChannels + 7) / 8];
+  unsigned long seen[MaxChannels]; // ms of the last visit
+  Queue    diffs;
+  uint16_t channels;
+  uint16_t sweep;      // next channel of the sweep
+  uint16_t hot;        // next candidate of the hot round robin
+  uint8_t  visits;     // hot visits since the last sweep visit
+  uint16_t channel;    // being visited
+  uint16_t saved;
+  uint8_t  slot;
+  unsigned long slotStart;
+  enum State { Idle, Monitoring, Stopping, Restoring } state;
+
+  void Clear(void) {
+    for(uint8_t s=0; s<Slots; s++)
+       for(uint16_t c=0; c<MaxChannels; c++)
+          map[s][c] = 0;
+    for(uint16_t c=0; c<MaxChannels; c++)
+       score[c] = rssi[c] = 0;
+    for(uint16_t i=0; i<sizeof(occupied); i++)
+       occupied[i] = 0;
+  }
+
+  void Visit(uint16_t Channel) {
+    channel = Channel;
+    radio.TuneAsync(Channel, Done, this);
+  }
+
+  static void Done(void* Context, const Status& S) {
+    ((RDA5807M_Monitor*) Context)->Sampled(S);
+  }
+
+  void Sampled(const Status& S) {
+    if (state == Restoring) {
+       state = Idle;
+       return;
+       }
+    if (state == Stopping) {
+       state = Restoring;
+       Visit(saved);
+       return;
+       }
+
+    // next slots, the oldest ones are overwritten; after a gap of more
+    // than Slots slots, all of them.
+    if (SlotTime) {
+       unsigned long late = (S.Time - slotStart) / SlotTime;
+       slotStart += late * SlotTime;
+       for(uint8_t n=0; (n < late) and (n < Slots); n++) {
+          slot = (slot + 1) % Slots;
+          for(uint16_t c=0; c<channels; c++)
+             map[slot][c] = 0;
+          }
+       }
+
+    uint8_t r = S.SignalStrength();
+    bool station = S.IsStation();
+    map[slot][channel] = (station << 7) | r;
+    Decay(channel, station, S.Time);
+    Visits++;
+
+    bool was = Occupied(channel);
+    bool is  = was ? (score[channel] >= 64) : (score[channel] >= 128);
+    uint8_t delta = (r > rssi[channel]) ? r - rssi[channel] : rssi[channel] - r;
+    if ((is != was) or (is and (delta >= RssiDelta))) {
+       RDA5807M_ChannelDiff d = { channel, r, is, S.Time };
+       diffs.Push(d);
+       }
+    if (is)
+       occupied[channel / 8] |= 1 << (channel % 8);
+    else
+       occupied[channel / 8] &= ~(1 << (channel % 8));
+    // the reference for RssiDelta moves on reported changes only.
+    if ((is != was) or (delta >= RssiDelta) or not is)
+       rssi[channel] = r;
+
+    Visit(Next());
+  }
+
+  void Decay(uint16_t Channel, bool Station, unsigned long Now) {
+    unsigned long t = Now - seen[Channel];
+    seen[Channel] = Now;
+    int16_t diff = (Station ? 255 : 0) - score[Channel];
+    if (t >= DecayTime)
+       score[Channel] += diff;
+    else if (t and diff) {
+       // at least one step, so the score reaches 0 and 255.
+       int16_t step = (int32_t) diff * (int32_t) t / (int32_t) DecayTime;
+       score[Channel] += step ? step : ((diff > 0) ? 1 : -1);
+       }
+  }
+
+  uint16_t Next(void) {
+    if (visits < HotShare) {
+       // round robin over the hot channels, max. one pass.
+       for(uint16_t n=0; n<channels; n++) {
+          uint16_t c = hot;
+          hot = (hot + 1) % channels;
+          if (score[c] and (c != channel)) {
+             visits++;
+             HotVisits++;
+             return c;
+             }
+          }
+       }
+    visits = 0;
+    uint16_t c = sweep;
+    sweep = (sweep + 1) % channels;
+    return c;
+  }
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#include <string.h>
+#include "RDA5807M_ODA.h"
+#include "RDA5807M_RDS.h"
+
+/*******************************************************************************
+ * RDA5807M_ODA
+ ******************************************************************************/
+RDA5807M_ODA::RDA5807M_ODA(void) : used(0) {
+  Reset();
+}
+
+bool RDA5807M_ODA::Register(uint16_t AID, Handler H, void* Context) {
+  if (used >= Slots)
+     return false;
+  slots[used].AID      = AID;
+  slots[used].Function = H;
+  slots[used].Context  = Context;
+  used++;
+  return true;
+}
+
+void RDA5807M_ODA::Reset(void) {
+  for(int i=0; i<32; i++) {
+     table[i].AID  = 0;
+     table[i].Slot = 0xFF;
+     }
+}
+
+bool RDA5807M_ODA::Decode(const RDA5807M_Group& G) {
+  if (G.BLERB > 2)
+     return false;
+
+  uint8_t type = G.Block[1] >> 11;
+  if (type == 0x06) {
+     // 3A: application group type in block B, AID in block D.
+     uint8_t  oda = G.Block[1] & 0x1F;
+     uint16_t aid = G.Block[3];
+     uint8_t  slot = 0xFF;
+     for(uint8_t i=0; i<used; i++)
+        if (slots[i].AID == aid)
+           slot = i;
+     // type 0: carried in 3A only, 0x1F: temporary data fault.
+     if (oda and (oda != 0x1F)) {
+        table[oda].AID  = aid;
+        table[oda].Slot = slot;
+        }
+     if (slot == 0xFF)
+        return false;
+     slots[slot].Function(slots[slot].Context, G);
+     return true;
+     }
+
+  const Entry& e = table[type];
+  if (e.Slot == 0xFF)
+     return false;
+  slots[e.Slot].Function(slots[e.Slot].Context, G);
+  return true;
+}
+
+
+/*******************************************************************************
+ * RDA5807M_RTPlus
+ ******************************************************************************/
+RDA5807M_RTPlus::RDA5807M_RTPlus(const RDA5807M_RDS& Rds) : rds(Rds) {
+  Reset();
+}
+
+void RDA5807M_RTPlus::Reset(void) {
+  memset(tags, 0, sizeof(tags));
+  toggle  = false;
+  running = false;
+}
+
+void RDA5807M_RTPlus::Handler(void* Context, const RDA5807M_Group& G) {
+  ((RDA5807M_RTPlus*) Context)->Decode(G);
+}
+
+void RDA5807M_RTPlus::Decode(const RDA5807M_Group& G) {
+  uint16_t B = G.Block[1], C = G.Block[2], D = G.Block[3];
+
+  // the 3A announcement holds only the template number and flags.
+  if (((B >> 11) == 0x06) or G.BLERB)
+     return;
+
+  bool t = (B & 0x10) > 0;
+  if (t != toggle)
+     memset(tags, 0, sizeof(tags)); // next item
+  toggle  = t;
+  running = (B & 0x08) > 0;
+
+  // content type 6 bit, start marker 6 bit, length marker 6 or 5 bit.
+  tags[0].ContentType = ((B & 7) << 3) | (C >> 13);
+  tags[0].Start       = (C >> 7) & 0x3F;
+  tags[0].Length      = ((C >> 1) & 0x3F) + 1;
+  tags[1].ContentType = ((C & 1) << 5) | (D >> 11);
+  tags[1].Start       = (D >> 5) & 0x3F;
+  tags[1].Length      = (D & 0x1F) + 1;
+}
+
+bool RDA5807M_RTPlus::Tag(uint8_t ContentType, char* Text, uint8_t Size) const {
+  if (not Size or not ContentType)
+     return false;
+
+  const char* rt = rds.RT();
+  uint8_t len = strlen(rt);
+  for(int i=0; i<2; i++) {
+     const Tagged& tag = tags[i];
+     if ((tag.ContentType != ContentType) or (tag.Start + tag.Length > len))
+        continue;
+     uint8_t n = (tag.Length < Size) ? tag.Length : Size - 1;
+     memcpy(Text, rt + tag.Start, n);
+     Text[n] = 0;
+     return true;
+     }
+  return false;
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_ODA_H
+#define RDA5807M_ODA_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M_Status.h"
+
+class RDA5807M_RDS;
+
+/*******************************************************************************
+ * Open Data Applications registry.
+ *
+ * Handlers register for an Application ID (AID). Group 3A announces, which
+ * group type carries an AID; Decode() then dispatches groups through a flat
+ * table of all 32 group types (type and version, block B >> 11), without
+ * search and without heap. The announcing 3A group is passed to the handler
+ * as well, as it's block C holds application data. An application group
+ * code of 0x1F in 3A is a temporary data fault (IEC 62106) and binds
+ * nothing.
+ ******************************************************************************/
+class RDA5807M_ODA {
+public:
+  typedef void (*Handler)(void* Context, const RDA5807M_Group& G);
+
+  /* max. number of registered applications. */
+  static constexpr uint8_t Slots = 4;
+
+  RDA5807M_ODA(void);
+
+  /* Register Handler for AID. Returns false, if all slots are in use. */
+  bool Register(uint16_t AID, Handler H, void* Context = 0);
+
+  /* forget the announcements, ie. after tuning to another channel.
+   * Registrations are kept.
+   */
+  void Reset(void);
+
+  /* Decode one group. Returns true, if it was passed to a handler. */
+  bool Decode(const RDA5807M_Group& G);
+
+  /* AID announced for a group type (0..31, block B >> 11), 0 if none. */
+  uint16_t AID(uint8_t GroupType) const { return table[GroupType & 31].AID; }
+
+private:
+  struct Slot {
+    uint16_t AID;
+    Handler  Function;
+    void*    Context;
+  } slots[Slots];
+  uint8_t used;
+
+  struct Entry {
+    uint16_t AID;
+    uint8_t  Slot;     // into slots[], 0xFF = no handler
+  } table[32];
+};
+
+
+/*******************************************************************************
+ * RadioText Plus (AID 0x4BD7), tags parts of the RadioText decoded by a
+ * RDA5807M_RDS, ie. artist and title:
+ *   RDA5807M_RDS    rds;
+ *   RDA5807M_RTPlus rtplus(rds);
+ *   RDA5807M_ODA    oda;
+ *   oda.Register(RDA5807M_RTPlus::AID, RDA5807M_RTPlus::Handler, &rtplus);
+ * Each group is then given to both, rds.Decode() and oda.Decode().
+ ******************************************************************************/
+class RDA5807M_RTPlus {
+public:
+  static constexpr uint16_t AID = 0x4BD7;
+
+  /* content types, see IEC 62106 */
+  enum {
+    Title  = 1,
+    Album  = 2,
+    Artist = 4,
+  };
+
+  RDA5807M_RTPlus(const RDA5807M_RDS& Rds);
+
+  void Reset(void);
+
+  /* RDA5807M_ODA handler, Context is the RDA5807M_RTPlus. */
+  static void Handler(void* Context, const RDA5807M_Group& G);
+
+  /* Copies the RadioText tagged as ContentType to Text (NUL terminated).
+   * Returns false, if not tagged in the current item.
+   */
+  bool Tag(uint8_t ContentType, char* Text, uint8_t Size) const;
+
+  /* item toggle and running bits of the last RT+ group. */
+  bool Toggle(void) const { return toggle; }
+  bool Running(void) const { return running; }
+
+private:
+  const RDA5807M_RDS& rds;
+  struct Tagged {
+    uint8_t ContentType;
+    uint8_t Start;
+    uint8_t Length;
+  } tags[2];
+  bool toggle;
+  bool running;
+
+  void Decode(const RDA5807M_Group& G);
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_PRESETS_H
+#define RDA5807M_PRESETS_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M.h"
+
+/*******************************************************************************
+ * Preset table of ready made register 0x03 images, see ChannelWord().
+ *
+ * Zap() is one 3 byte write (ZapAsync()), completed by Step() on STC. With
+ * Mute, the audio is muted (DMUTE) before and enabled Settle ms after STC,
+ * which hides the noise while the PLL and stereo decoder settle, at the
+ * cost of two more writes. The words hold the band and spacing, so presets
+ * may be in the bands 0..2 and in the Band() 3 or 4 selected, and can be
+ * kept as they are, ie. in EEPROM. Band 3 and 4 share BAND = 3 and differ
+ * in MODE_65MHz (register 0x07), which Zap() doesn't write: so a preset
+ * stored in band 3 or 4 is refused, while the radio is in the other one.
+ *
+ *   RDA5807M_Presets<RDA5807M_Wire> presets(radio);
+ *   presets.Store(0, 66); // 93.6MHz, band 0, 100kHz
+ *   presets.Zap(0);
+ *   loop: presets.Step();
+ ******************************************************************************/
+template<class Transport, uint8_t Size = 16>
+class RDA5807M_Presets {
+public:
+  typedef RDA5807M_Driver<Transport> Driver;
+  typedef typename Driver::Status Status;
+
+  RDA5807M_Presets(Driver& Radio) : Mute(false), Settle(10), radio(Radio),
+    current(0xFF), state(Idle), started(0), stcAt(0), latency(0) {
+    for(uint8_t n=0; n<Size; n++)
+       word[n] = 0;
+    for(uint8_t i=0; i<sizeof(band4); i++)
+       band4[i] = 0;
+  }
+
+  /* mute during the zap */
+  bool Mute;
+
+  /* ms between STC and enabling the audio, with Mute */
+  unsigned long Settle;
+
+  /* preset n: Channel of the current band and spacing, or the raw word.
+   * A raw word with BAND = 3 is taken as of the current Band() 3 or 4.
+   */
+  void Store(uint8_t n, uint16_t Channel) { Word(n, radio.ChannelWord(Channel)); }
+  void Word(uint8_t n, uint16_t Word) {
+    n %= Size;
+    word[n] = Word;
+    if (Band4())
+       band4[n / 8] |= 1 << (n % 8);
+    else
+       band4[n / 8] &= ~(1 << (n % 8));
+  }
+  uint16_t Word(uint8_t n) const { return word[n % Size]; }
+
+  /* Tunes preset n. Returns false, if it's empty, a tune/seek is pending or
+   * it's of band 3 or 4 and the radio is in the other one.
+   */
+  bool Zap(uint8_t n) {
+    n %= Size;
+    if ((state != Idle) or not word[n] or radio.Busy())
+       return false;
+    if ((RDA5807M_Reg::BAND.Decode(word[n]) == 3) and
+        (Band4() != ((band4[n / 8] >> (n % 8)) & 1)))
+       return false;
+    started = radio.Bus().Millis();
+    if (Mute)
+       radio.Muted(true);
+    current = n;
+    state   = Tuning;
+    return radio.ZapAsync(word[n], Done, this);
+  }
+
+  /* Advances a zap. Returns true, while it's running. */
+  bool Step(void) {
+    switch(state) {
+       case Tuning:
+          radio.Service();
+          break;
+       case Settling:
+          if ((radio.Bus().Millis() - stcAt) >= Settle)
+             Audio();
+          break;
+       default:
+          break;
+       }
+    return state != Idle;
+  }
+
+  bool Busy(void) const { return state != Idle; }
+
+  /* last preset zapped to, 0xFF = none */
+  uint8_t Current(void) const { return current; }
+
+  /* ms from Zap() to audio (STC, or unmute with Mute) of the last zap. */
+  unsigned long Latency(void) const { return latency; }
+
+private:
+  enum State { Idle, Tuning, Settling };
+
+  Driver&  radio;
+  uint16_t word[Size];
+  uint8_t  band4[(Size + 7) / 8]; // stored with MODE_65MHz = 0, 50..65MHz
+  uint8_t  current;
+  State    state;
+  unsigned long started;   // ms
+  unsigned long stcAt;     // ms
+  unsigned long latency;   // ms
+
+  // Band() 4 is the only one with MODE_65MHz = 0.
+  bool Band4(void) const { return radio.BandStart() == 50000; }
+
+  static void Done(void* Context, const Status&) {
+    ((RDA5807M_Presets*) Context)->Tuned();
+  }
+
+  void Tuned(void) {
+    stcAt = radio.Bus().Millis();
+    if (Mute and Settle) {
+       state = Settling;
+       return;
+       }
+    Audio();
+  }
+
+  void Audio(void) {
+    if (Mute)
+       radio.Muted(false);
+    latency = radio.Bus().Millis() - started;
+    state   = Idle;
+  }
+};
+
+#endif
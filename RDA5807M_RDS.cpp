@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#include <string.h>
+#include "RDA5807M_RDS.h"
+
+RDA5807M_RDS::RDA5807M_RDS(void) : Threshold(3) {
+  Reset();
+}
+
+void RDA5807M_RDS::Reset(void) {
+  pi.Clear();
+  Groups   = 0;
+  Rejected = 0;
+  Station();
+}
+
+void RDA5807M_RDS::Station(void) {
+  pty.Clear();
+  for(int i=0; i<4; i++)
+     psVote[i].Clear();
+  memset(ps, ' ', 8);
+  ps[8]  = 0;
+  ta     = false;
+  ms     = false;
+  mjd    = 0;
+  hour   = 0;
+  minute = 0;
+  offset = 0;
+  ct     = false;
+  ClearRT(false, false);
+  rtSeen = false;
+}
+
+void RDA5807M_RDS::ClearRT(bool AB, bool VersionB) {
+  // 2A transmits up to 64 chars, 2B up to 32.
+  uint8_t max = VersionB ? 32 : 64;
+  for(int i=0; i<32; i++)
+     rtVote[i].Clear();
+  memset(rt, ' ', max);
+  memset(rt + max, 0, sizeof(rt) - max);
+  rtAB       = AB;
+  rtVersionB = VersionB;
+}
+
+bool RDA5807M_RDS::Vote::Add(uint16_t V, uint8_t Weight) {
+  if (V == Value) {
+     Confidence += Weight;
+     if (Confidence > 7) Confidence = 7;
+     return false;
+     }
+  if (Weight >= Confidence) {
+     Value      = V;
+     Confidence = Weight;
+     return true;
+     }
+  Confidence -= Weight;
+  return false;
+}
+
+void RDA5807M_RDS::Text(Vote* V, char* Text, uint8_t Index, uint16_t Chars, uint8_t Weight) {
+  if (not V[Index].Add(Chars, Weight))
+     return;
+
+  char* p = Text + 2 * Index;
+  for(int i=0; i<2; i++, Chars <<= 8) {
+     char c = Chars >> 8;
+     if (c == 0x0D)
+        c = 0; // end of RadioText
+     else if ((uint8_t) c < 0x20)
+        c = ' ';
+     p[i] = c;
+     }
+}
+
+static uint8_t Weight(uint8_t Errors) {
+  // 0 = no errors, 1..2 = corrected, 3 = uncorrectable
+  return (Errors == 0) ? 2 : (Errors < 3) ? 1 : 0;
+}
+
+bool RDA5807M_RDS::Decode(const RDA5807M_Group& G) {
+  uint8_t wA = Weight(G.BLERA);
+  uint8_t wB = Weight(G.BLERB);
+  uint16_t B = G.Block[1];
+  uint8_t type = B >> 12;
+  bool versionB = (B & 0x0800) > 0;
+
+  // a new PI, which outvoted the stored one, is another station.
+  Groups++;
+  if (wA and pi.Add(G.Block[0], wA))
+     Station();
+  if (not wB) {
+     Rejected++;
+     return false;
+     }
+  if (versionB and pi.Add(G.Block[2], wB))
+     Station();
+
+  pty.Add(B & 0x07E0, wB);
+
+  switch(type) {
+     case 0:
+        ta = (B & 0x10) > 0;
+        ms = (B & 0x08) > 0;
+        Text(psVote, ps, B & 3, G.Block[3], wB);
+        break;
+     case 2: {
+        bool ab = (B & 0x10) > 0;
+        if (not rtSeen or (ab != rtAB) or (versionB != rtVersionB))
+           ClearRT(ab, versionB);
+        rtSeen = true;
+        uint8_t address = B & 0x0F;
+        if (versionB)
+           Text(rtVote, rt, address, G.Block[3], wB);
+        else {
+           Text(rtVote, rt, 2 * address,     G.Block[2], wB);
+           Text(rtVote, rt, 2 * address + 1, G.Block[3], wB);
+           }
+        break;
+        }
+     case 4:
+        if (not versionB and (wB == 2)) {
+           uint16_t C = G.Block[2], D = G.Block[3];
+           uint8_t h  = ((C & 1) << 4) | (D >> 12);
+           uint8_t m  = (D >> 6) & 0x3F;
+           int8_t  o  = (D & 0x1F) * ((D & 0x20) ? -1 : 1);
+           if ((h < 24) and (m < 60) and (o >= -28) and (o <= 28)) {
+              mjd    = ((uint32_t) (B & 3) << 15) | (C >> 1);
+              hour   = h;
+              minute = m;
+              offset = o;
+              ct     = true;
+              }
+           }
+        break;
+     default:
+        break;
+     }
+  return true;
+}
+
+uint8_t RDA5807M_RDS::PS_Segments(void) const {
+  uint8_t s = 0;
+  for(int i=0; i<4; i++)
+     if (psVote[i].Confidence >= Threshold)
+        s |= 1 << i;
+  return s;
+}
+
+uint32_t RDA5807M_RDS::RT_Segments(void) const {
+  uint32_t s = 0;
+  for(int i=0; i<32; i++)
+     if (rtVote[i].Confidence >= Threshold)
+        s |= (uint32_t) 1 << i;
+  return s;
+}
+
+uint8_t RDA5807M_RDS::RT_Length(void) const {
+  return strlen(rt);
+}
+
+uint8_t RDA5807M_RDS::Valid(void) const {
+  uint8_t v = 0;
+  if (pi.Confidence >= Threshold)  v |= ValidPI;
+  if (pty.Confidence >= Threshold) v |= ValidPTY;
+  if (PS_Segments() == 0x0F)       v |= ValidPS;
+  if (ct)                          v |= ValidCT;
+
+  if (rtSeen) {
+     // all char pairs up to and including the one holding 0x0D.
+     uint8_t max  = rtVersionB ? 32 : 64;
+     uint8_t len  = RT_Length();
+     uint8_t need = (len < max) ? len / 2 + 1 : max / 2;
+     uint32_t mask = (need < 32) ? ((uint32_t) 1 << need) - 1 : 0xFFFFFFFF;
+     if ((RT_Segments() & mask) == mask)
+        v |= ValidRT;
+     }
+  return v;
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_RDS_H
+#define RDA5807M_RDS_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M_Status.h"
+
+/*******************************************************************************
+ * Incremental RDS decoder for the core group types, fed one RDA5807M_Group
+ * at a time (ie. from Capture() or Drain()), without heap and with fixed
+ * buffers (approx. 130 bytes).
+ *
+ * - PI (block A, block C' of version B groups)
+ * - PTY, TP (all groups)
+ * - TA, MS, PS (0A/0B)
+ * - RadioText (2A/2B)
+ * - CT, clock time and date (4A)
+ *
+ * The chip reports error levels for block A and B only; block B's level is
+ * therefore taken for C and D as well. Groups with an uncorrectable block B
+ * are rejected. Every value (PI, PTY/TP, each PS and RT character pair) is
+ * voted on: an error free block counts 2, a corrected one 1. A differing
+ * value replaces the stored one, once it's weight reaches the confidence of
+ * the stored one, which is reduced otherwise. A value is reliable, if it's
+ * confidence reaches Threshold. With the default of 3, a character pair is
+ * reliable after two error free receptions.
+ ******************************************************************************/
+class RDA5807M_RDS {
+public:
+  RDA5807M_RDS(void);
+
+  /* forget everything, ie. after tuning to another channel. */
+  void Reset(void);
+
+  /* Decode one group. Returns false, if the group was rejected. */
+  bool Decode(const RDA5807M_Group& G);
+
+  /* per field completeness, see Valid(). */
+  enum Fields {
+    ValidPI  = 0x01,
+    ValidPTY = 0x02,  // PTY and TP
+    ValidPS  = 0x04,
+    ValidRT  = 0x08,
+    ValidCT  = 0x10,
+  };
+
+  /* Returns the Fields being reliable. */
+  uint8_t Valid(void) const;
+
+  /* Program Identification. */
+  uint16_t PI(void) const { return pi.Value; }
+
+  /* Program Type, 0..31. */
+  uint8_t PTY(void) const { return (pty.Value >> 5) & 0x1F; }
+
+  /* Traffic Program, Traffic Announcement, Music/Speech. */
+  bool TP(void) const { return (pty.Value & 0x400) > 0; }
+  bool TA(void) const { return ta; }
+  bool MS(void) const { return ms; }
+
+  /* Program Service name, 8 chars + NUL. Not yet received chars are ' '. */
+  const char* PS(void) const { return ps; }
+
+  /* bit n set = PS chars 2n, 2n+1 are reliable. */
+  uint8_t PS_Segments(void) const;
+
+  /* RadioText, up to 64 chars + NUL, without the trailing 0x0D. */
+  const char* RT(void) const { return rt; }
+
+  /* bit n set = RT chars 2n, 2n+1 are reliable. */
+  uint32_t RT_Segments(void) const;
+
+  /* Number of RT chars, as far as known. */
+  uint8_t RT_Length(void) const;
+
+  /* Clock time and date of the last 4A group: Modified Julian Date, UTC
+   * hour and minute, local time offset in multiples of 30 minutes.
+   */
+  uint32_t MJD(void) const { return mjd; }
+  uint8_t  Hour(void) const { return hour; }
+  uint8_t  Minute(void) const { return minute; }
+  int8_t   Offset(void) const { return offset; }
+
+  /* Minimum confidence of a reliable value, 1..7. */
+  uint8_t Threshold;
+
+  /* statistics */
+  uint32_t Groups;
+  uint32_t Rejected;
+
+private:
+  struct Vote {
+    uint16_t Value;
+    uint8_t  Confidence;
+    void Clear(void) { Value = 0; Confidence = 0; }
+    bool Add(uint16_t V, uint8_t Weight);
+  };
+
+  Vote pi;
+  Vote pty;
+  Vote psVote[4];
+  Vote rtVote[32];
+  char ps[9];
+  char rt[65];
+  bool ta, ms;
+  bool rtSeen;
+  bool rtAB;
+  bool rtVersionB;
+  uint32_t mjd;
+  uint8_t  hour, minute;
+  int8_t   offset;
+  bool     ct;
+
+  void Station(void);
+  void ClearRT(bool AB, bool VersionB);
+  void Text(Vote* V, char* Text, uint8_t Index, uint16_t Chars, uint8_t Weight);
+};
+
+#endif
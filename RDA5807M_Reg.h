@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_REG_H
+#define RDA5807M_REG_H
+
+#include <stdint.h> // uint{8,16,32}_t
+
+/*******************************************************************************
+ * A bit field in one of the writable registers 0x02..0x08.
+ ******************************************************************************/
+struct RDA5807M_Field {
+  uint8_t Register;
+  uint8_t Shift;
+  uint8_t Width;
+
+  constexpr uint16_t Mask(void) const {
+    return ((1UL << Width) - 1) << Shift;
+  }
+
+  constexpr uint16_t Encode(uint16_t Value) const {
+    return (Value << Shift) & Mask();
+  }
+
+  constexpr uint16_t Decode(uint16_t Word) const {
+    return (Word & Mask()) >> Shift;
+  }
+};
+
+
+/*******************************************************************************
+ * Register map, names as in the data sheet.
+ ******************************************************************************/
+namespace RDA5807M_Reg {
+  //--- 0x02
+  constexpr RDA5807M_Field DHIZ                    = { 0x02, 15,  1 };
+  constexpr RDA5807M_Field DMUTE                   = { 0x02, 14,  1 };
+  constexpr RDA5807M_Field MONO                    = { 0x02, 13,  1 };
+  constexpr RDA5807M_Field BASS                    = { 0x02, 12,  1 };
+  constexpr RDA5807M_Field RCLK_NON_CALIBRATE_MODE = { 0x02, 11,  1 };
+  constexpr RDA5807M_Field RCLK_DIRECT_INPUT_MODE  = { 0x02, 10,  1 };
+  constexpr RDA5807M_Field SEEKUP                  = { 0x02,  9,  1 };
+  constexpr RDA5807M_Field SEEK                    = { 0x02,  8,  1 };
+  constexpr RDA5807M_Field SKMODE                  = { 0x02,  7,  1 };
+  constexpr RDA5807M_Field CLK_MODE                = { 0x02,  4,  3 };
+  constexpr RDA5807M_Field RDS_EN                  = { 0x02,  3,  1 };
+  constexpr RDA5807M_Field NEW_METHOD              = { 0x02,  2,  1 };
+  constexpr RDA5807M_Field SOFT_RESET              = { 0x02,  1,  1 };
+  constexpr RDA5807M_Field ENABLE                  = { 0x02,  0,  1 };
+  //--- 0x03
+  constexpr RDA5807M_Field CHAN                    = { 0x03,  6, 10 };
+  constexpr RDA5807M_Field DIRECT_MODE             = { 0x03,  5,  1 };
+  constexpr RDA5807M_Field TUNE                    = { 0x03,  4,  1 };
+  constexpr RDA5807M_Field BAND                    = { 0x03,  2,  2 };
+  constexpr RDA5807M_Field SPACE                   = { 0x03,  0,  2 };
+  //--- 0x04
+  constexpr RDA5807M_Field RDSIEN                  = { 0x04, 15,  1 };
+  constexpr RDA5807M_Field STCIEN                  = { 0x04, 14,  1 };
+  constexpr RDA5807M_Field RBDS                    = { 0x04, 13,  1 };
+  constexpr RDA5807M_Field RDS_FIFO_EN             = { 0x04, 12,  1 };
+  constexpr RDA5807M_Field DE                      = { 0x04, 11,  1 };
+  constexpr RDA5807M_Field RDS_FIFO_CLR            = { 0x04, 10,  1 };
+  constexpr RDA5807M_Field SOFTMUTE_EN             = { 0x04,  9,  1 };
+  constexpr RDA5807M_Field AFCD                    = { 0x04,  8,  1 };
+  constexpr RDA5807M_Field I2S_ENABLE              = { 0x04,  6,  1 };
+  constexpr RDA5807M_Field GPIO3                   = { 0x04,  4,  2 };
+  constexpr RDA5807M_Field GPIO2                   = { 0x04,  2,  2 };
+  constexpr RDA5807M_Field GPIO1                   = { 0x04,  0,  2 };
+  //--- 0x05
+  constexpr RDA5807M_Field INT_MODE                = { 0x05, 15,  1 };
+  constexpr RDA5807M_Field SEEK_MODE               = { 0x05, 13,  2 };
+  constexpr RDA5807M_Field SEEKTH                  = { 0x05,  8,  4 };
+  constexpr RDA5807M_Field LNA_PORT_SEL            = { 0x05,  6,  2 };
+  constexpr RDA5807M_Field LNA_ICSEL_BIT           = { 0x05,  4,  2 };
+  constexpr RDA5807M_Field VOLUME                  = { 0x05,  0,  4 };
+  //--- 0x06
+  constexpr RDA5807M_Field OPEN_MODE               = { 0x06, 13,  2 };
+  constexpr RDA5807M_Field SLAVE_MASTER            = { 0x06, 12,  1 };
+  constexpr RDA5807M_Field WS_LR                   = { 0x06, 11,  1 };
+  constexpr RDA5807M_Field SCLK_I_EDGE             = { 0x06, 10,  1 };
+  constexpr RDA5807M_Field DATA_SIGNED             = { 0x06,  9,  1 };
+  constexpr RDA5807M_Field WS_I_EDGE               = { 0x06,  8,  1 };
+  constexpr RDA5807M_Field I2S_SW_CNT              = { 0x06,  4,  4 };
+  constexpr RDA5807M_Field SW_O_EDGE               = { 0x06,  3,  1 };
+  constexpr RDA5807M_Field SCLK_O_EDGE             = { 0x06,  2,  1 };
+  constexpr RDA5807M_Field L_DELY                  = { 0x06,  1,  1 };
+  constexpr RDA5807M_Field R_DELY                  = { 0x06,  0,  1 };
+  //--- 0x07
+  constexpr RDA5807M_Field TH_SOFTBLEND            = { 0x07, 10,  5 };
+  constexpr RDA5807M_Field MODE_65MHz              = { 0x07,  9,  1 };
+  constexpr RDA5807M_Field SEEK_TH_OLD             = { 0x07,  2,  6 };
+  constexpr RDA5807M_Field SOFTBLEND_EN            = { 0x07,  1,  1 };
+  constexpr RDA5807M_Field FREQ_MODE               = { 0x07,  0,  1 };
+  //--- 0x08
+  constexpr RDA5807M_Field FREQ_DIRECT             = { 0x08,  0, 16 };
+
+  /* Bits which trigger an action on the chip and must not be rewritten
+   * unless changed, per register 0x02..0x08.
+   */
+  constexpr uint16_t Triggers[7] = {
+    SEEK.Mask() | SOFT_RESET.Mask(), TUNE.Mask(), RDS_FIFO_CLR.Mask(),
+    0, 0, 0, 0 };
+
+  /* Driver defaults of 0x02..0x08: audio on, unmuted, seek up and stop at
+   * band limits, powered up, channel 5 of 87..108MHz at 100kHz, 50us
+   * de-emphasis, seek threshold 8, LNA (+) input, volume 11, softblend on
+   * at threshold 16.
+   */
+  constexpr uint16_t Defaults[7] = {
+    DHIZ.Encode(1) | DMUTE.Encode(1) | SEEKUP.Encode(1) | SKMODE.Encode(1) |
+       ENABLE.Encode(1),
+    CHAN.Encode(5),
+    DE.Encode(1),
+    INT_MODE.Encode(1) | SEEKTH.Encode(8) | LNA_PORT_SEL.Encode(2) |
+       VOLUME.Encode(11),
+    0,
+    TH_SOFTBLEND.Encode(16) | MODE_65MHz.Encode(1) | SOFTBLEND_EN.Encode(1),
+    0 };
+
+  /* Replaces field F in register word Word. */
+  constexpr uint16_t With(uint16_t Word, RDA5807M_Field F, uint16_t Value) {
+    return (Word & ~F.Mask()) | F.Encode(Value);
+  }
+}
+
+
+/*******************************************************************************
+ * Power up configuration, to be turned into a register image at compile time:
+ *
+ *   constexpr RDA5807M_Config config = {
+ *     0,     // Band: 87..108MHz
+ *     0,     // Spacing: 100kHz
+ *     0,     // Clock: 32.768kHz
+ *     true,  // Deemphasis: 50us (Europe)
+ *     8,     // Volume
+ *     2,     // LNA_Port: (+) input
+ *     0,     // LNA_Current: 1.8mA
+ *     false, // I2S
+ *     true,  // RDS
+ *     6      // Channel: 87.6MHz
+ *   };
+ *   constexpr RDA5807M_Image image = RDA5807M_PowerUpImage(config);
+ *
+ * Values as for the setters of the same name.
+ ******************************************************************************/
+struct RDA5807M_Config {
+  uint8_t  Band;
+  uint8_t  Spacing;
+  uint8_t  Clock;
+  bool     Deemphasis;
+  uint8_t  Volume;
+  uint8_t  LNA_Port;
+  uint8_t  LNA_Current;
+  bool     I2S;
+  bool     RDS;
+  uint16_t Channel;
+};
+
+/* Registers 0x02..0x08 */
+struct RDA5807M_Image {
+  uint16_t Wr[7];
+};
+
+/* Driver defaults with the configuration applied. TUNE is set, so that the
+ * chip tunes to Channel as soon as it's powered up.
+ */
+constexpr RDA5807M_Image RDA5807M_PowerUpImage(const RDA5807M_Config& C) {
+  using namespace RDA5807M_Reg;
+  return { {
+    With(With(With(Defaults[0],
+       CLK_MODE, C.Clock),
+       RDS_EN, C.RDS),
+       ENABLE, 1),
+    With(With(With(With(Defaults[1],
+       CHAN, C.Channel),
+       TUNE, 1),
+       BAND, C.Band == 4 ? 3 : C.Band),
+       SPACE, C.Spacing),
+    With(With(Defaults[2],
+       DE, C.Deemphasis),
+       I2S_ENABLE, C.I2S),
+    With(With(With(Defaults[3],
+       LNA_PORT_SEL, C.LNA_Port),
+       LNA_ICSEL_BIT, C.LNA_Current),
+       VOLUME, C.Volume),
+    Defaults[4],
+    With(Defaults[5],
+       MODE_65MHz, C.Band != 4),
+    Defaults[6] } };
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_RING_H
+#define RDA5807M_RING_H
+
+#include <stdint.h> // uint{8,16,32}_t
+
+/*******************************************************************************
+ * Lock-free single producer / single consumer ring buffer of N entries of T.
+ *
+ * Push() may be called from one context (ie. an interrupt handler or a
+ * reader thread) while Pop() is called from another one (ie. loop()),
+ * without locks or disabling interrupts. Both indices are 8 bit, so that
+ * their loads and stores are atomic on 8-bit MCUs as well; therefore N is
+ * a power of two, max. 128.
+ ******************************************************************************/
+template<class T, uint8_t N>
+class RDA5807M_Ring {
+private:
+  static_assert((N & (N - 1)) == 0 and N <= 128, "N must be a power of two, max. 128");
+  T items[N];
+  uint8_t head;     // written by producer only
+  uint8_t tail;     // written by consumer only
+  uint16_t dropped; // written by producer only
+
+public:
+  RDA5807M_Ring(void) : head(0), tail(0), dropped(0) {}
+
+  /* producer side. Returns false, if full; the item is dropped then. */
+  bool Push(const T& Item) {
+    uint8_t h = head;
+    uint8_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+    if ((uint8_t)(h - t) >= N) {
+       dropped++;
+       return false;
+       }
+    items[h & (N - 1)] = Item;
+    __atomic_store_n(&head, (uint8_t)(h + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /* consumer side. Returns false, if empty. */
+  bool Pop(T& Item) {
+    uint8_t t = tail;
+    uint8_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    if (h == t)
+       return false;
+    Item = items[t & (N - 1)];
+    __atomic_store_n(&tail, (uint8_t)(t + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /* number of queued items, exact only from either side. */
+  uint8_t Size(void) const {
+    return __atomic_load_n(&head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+  }
+
+  bool Empty(void) const { return Size() == 0; }
+
+  /* items lost because the ring was full. */
+  uint16_t Dropped(void) const { return dropped; }
+};
+
+#endif
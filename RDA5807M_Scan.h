@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_SCAN_H
+#define RDA5807M_SCAN_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M.h"
+
+/*******************************************************************************
+ * One entry of a station table.
+ ******************************************************************************/
+struct RDA5807M_Station {
+  enum { Stereo = 0x01 };
+  uint16_t Channel;   // channel number of the Band() and ChannelSpacing()
+  uint8_t  Rssi;      // 0..127
+  uint8_t  Flags;     // Stereo
+};
+
+
+/*******************************************************************************
+ * Appends S to a station table sorted by channel, S being above all channels
+ * in it. If the table is full, the weakest station is replaced (of equally
+ * weak ones, the highest channel), if S is stronger. So the table always
+ * holds the Size strongest stations (of equally strong ones, the lowest
+ * channels), regardless of how a scan was split up.
+ ******************************************************************************/
+inline void RDA5807M_Insert(RDA5807M_Station* Table, uint8_t Size, uint8_t& Count,
+                            const RDA5807M_Station& S) {
+  if (Count == Size) {
+     uint8_t weakest = 0;
+     for(uint8_t i=1; i<Count; i++)
+        if (Table[i].Rssi <= Table[weakest].Rssi)
+           weakest = i;
+     if (Table[weakest].Rssi >= S.Rssi)
+        return;
+     for(uint8_t i=weakest; i+1 < Count; i++)
+        Table[i] = Table[i+1];
+     Count--;
+     }
+  Table[Count++] = S;
+}
+
+
+/*******************************************************************************
+ * Full band scan, as a state machine on top of TuneAsync(), so that several
+ * scans (or other work) may run interleaved.
+ *
+ * Every channel of the current Band() and ChannelSpacing() is tuned, and
+ * sampled as soon as STC is set (with AsyncInterrupt(true) on the GPIO2
+ * edge, otherwise polled every 5ms). Channels without FM_TRUE or below
+ * MinRssi are left immediately; candidates are sampled again after Dwell
+ * ms, for a settled stereo indicator and RSSI. Stations are written to a
+ * table sorted by channel; if it's full, the weakest one is replaced. At
+ * the end, the channel tuned before is restored.
+ *
+ *   RDA5807M_Station table[32];
+ *   RDA5807M_Scanner<RDA5807M_Wire> scan(radio);
+ *   scan.Start(table, 32);
+ *   while(scan.Step()) {}
+ ******************************************************************************/
+template<class Transport>
+class RDA5807M_Scanner {
+public:
+  typedef RDA5807M_Driver<Transport> Driver;
+  typedef typename Driver::Status Status;
+
+  RDA5807M_Scanner(Driver& Radio) : MinRssi(0), Dwell(10), radio(Radio),
+    table(0), size(0), count(0), channel(0), last(0), saved(0), state(Idle),
+    started(0), tunedAt(0), duration(0), rssi(0) {}
+
+  /* min. RSSI of a station */
+  uint8_t MinRssi;
+
+  /* ms between STC and the second sample of a candidate, 0 = none. */
+  unsigned long Dwell;
+
+  /* Starts a scan of the channels First..Last into Table.
+   * Returns false, if a tune/seek is pending or the range is empty.
+   */
+  bool Start(RDA5807M_Station* Table, uint8_t Size, uint16_t First = 0,
+             uint16_t Last = 0xFFFF) {
+    if (Last >= radio.Channels())
+       Last = radio.Channels() - 1;
+    if (radio.Busy() or (state != Idle) or not Size or (First > Last))
+       return false;
+    table   = Table;
+    size    = Size;
+    count   = 0;
+    channel = First;
+    last    = Last;
+    saved   = radio.Channel();
+    started = radio.Bus().Millis();
+    Tune(channel, Scanning);
+    return true;
+  }
+
+  /* Advances the scan. Returns true, while the scan is running. */
+  bool Step(void) {
+    switch(state) {
+       case Scanning:
+       case Restoring:
+          radio.Service();
+          break;
+       case Sampling:
+          if ((radio.Bus().Millis() - tunedAt) >= Dwell) {
+             Sample(radio.ReadStatus(Driver::SignalStatus));
+             Next();
+             }
+          break;
+       default:
+          break;
+       }
+    return state != Idle;
+  }
+
+  bool Busy(void) const { return state != Idle; }
+
+  /* stations found so far, and the channel being scanned. */
+  uint8_t Found(void) const { return count; }
+  uint16_t Channel(void) const { return channel; }
+
+  /* ms of the last complete scan. */
+  unsigned long Duration(void) const { return duration; }
+
+private:
+  enum State { Idle, Scanning, Sampling, Restoring };
+
+  Driver& radio;
+  RDA5807M_Station* table;
+  uint8_t  size;
+  uint8_t  count;
+  uint16_t channel;
+  uint16_t last;
+  uint16_t saved;
+  State    state;
+  unsigned long started;
+  unsigned long tunedAt;
+  unsigned long duration;
+  uint8_t  rssi;
+
+  void Tune(uint16_t Channel, State Next) {
+    state = Next;
+    radio.TuneAsync(Channel, Done, this);
+  }
+
+  static void Done(void* Context, const Status& S) {
+    ((RDA5807M_Scanner*) Context)->Tuned(S);
+  }
+
+  void Tuned(const Status& S) {
+    if (state == Restoring) {
+       state    = Idle;
+       duration = S.Time - started;
+       return;
+       }
+
+    // an obviously empty channel.
+    if (not S.IsStation() or (S.SignalStrength() < MinRssi)) {
+       Next();
+       return;
+       }
+    if (Dwell == 0) {
+       Sample(S);
+       Next();
+       return;
+       }
+    rssi    = S.SignalStrength();
+    tunedAt = S.Time;
+    state   = Sampling;
+  }
+
+  void Sample(const Status& S) {
+    if (not S.IsStation())
+       return;
+    RDA5807M_Station s;
+    s.Channel = channel;
+    s.Rssi    = (S.SignalStrength() > rssi) ? S.SignalStrength() : rssi;
+    s.Flags   = S.StereoIndicator() ? RDA5807M_Station::Stereo : 0;
+    if (s.Rssi < MinRssi)
+       return;
+    RDA5807M_Insert(table, size, count, s);
+  }
+
+  void Next(void) {
+    rssi = 0;
+    if (channel < last)
+       Tune(++channel, Scanning);
+    else
+       Tune(saved, Restoring);
+  }
+};
+
+#endif
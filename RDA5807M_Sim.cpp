@@ -0,0 +1,510 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#include <string.h>
+#include "RDA5807M_Sim.h"
+
+/*******************************************************************************
+ * register bits used by the model
+ ******************************************************************************/
+static constexpr uint16_t R02_MONO       = 1 << 13;
+static constexpr uint16_t R02_SEEKUP     = 1 << 9;
+static constexpr uint16_t R02_SEEK       = 1 << 8;
+static constexpr uint16_t R02_SKMODE     = 1 << 7;
+static constexpr uint16_t R02_RDS_EN     = 1 << 3;
+static constexpr uint16_t R02_SOFT_RESET = 1 << 1;
+static constexpr uint16_t R02_ENABLE     = 1;
+static constexpr uint16_t R03_TUNE       = 1 << 4;
+static constexpr uint16_t R04_RDSIEN     = 1 << 15;
+static constexpr uint16_t R04_STCIEN     = 1 << 14;
+static constexpr uint16_t R04_FIFO_EN    = 1 << 12;
+static constexpr uint16_t R04_FIFO_CLR   = 1 << 10;
+static constexpr uint16_t R04_GPIO2      = 3 << 2;
+static constexpr uint16_t R04_GPIO2_INT  = 1 << 2;
+static constexpr uint16_t R07_65M_50M    = 1 << 9;
+
+static constexpr uint16_t ChipId = 0x5804;
+
+
+RDA5807M_Sim::RDA5807M_Sim(void) :
+  PowerUpTime(100000),
+  TuneTime(10000),
+  SeekStepTime(10000),
+  GroupTime(87719),
+  PollTime(50),
+  BusClock(100000),
+  FifoDepth(8),
+  NoiseRssi(10),
+  MJD(61000),
+  Transactions(0),
+  BusBytes(0),
+  FifoOverflows(0),
+  now(0),
+  stations(0),
+  count(0),
+  random(0x12345678),
+  handler(0),
+  context(0) {
+  memset(BlockErrorRate, 0, sizeof(BlockErrorRate));
+  Reset();
+}
+
+void RDA5807M_Sim::Reset(void) {
+  memset(reg, 0, sizeof(reg));
+  reg[0x05] = 0x0888;
+  reg[0x07] = 0x4202;
+  index     = 0x0A;
+  powered   = false;
+  readyAt   = 0;
+  busy      = false;
+  doneAt    = 0;
+  target    = 0;
+  seeking   = false;
+  failing   = false;
+  readchan  = 0;
+  stc       = false;
+  sf        = false;
+  rdsr      = false;
+  memset(block, 0, sizeof(block));
+  blera     = 0;
+  blerb     = 0;
+  fifoHead  = 0;
+  fifoCount = 0;
+  nextGroup = 0;
+  groups    = 0;
+  psSegment = 0;
+  rtSegment = 0;
+  minute    = 0xFFFFFFFF;
+}
+
+void RDA5807M_Sim::Stations(const Station* List, uint8_t Count) {
+  stations = List;
+  count = Count;
+}
+
+unsigned long RDA5807M_Sim::Millis(void) {
+  now += PollTime;
+  Update();
+  return now / 1000;
+}
+
+void RDA5807M_Sim::Advance(uint32_t Microseconds) {
+  now += Microseconds;
+  Update();
+}
+
+uint32_t RDA5807M_Sim::Rand(void) {
+  // xorshift32, reproducible between runs.
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return random;
+}
+
+
+/*******************************************************************************
+ * band
+ ******************************************************************************/
+uint32_t RDA5807M_Sim::BandStart(void) {
+  switch((reg[0x03] >> 2) & 3) {
+     case 0 : return 87000;
+     case 1 :
+     case 2 : return 76000;
+     default: return (reg[0x07] & R07_65M_50M) ? 65000 : 50000;
+     }
+}
+
+uint32_t RDA5807M_Sim::BandEnd(void) {
+  switch((reg[0x03] >> 2) & 3) {
+     case 0 : return 108000;
+     case 1 : return 91000;
+     case 2 : return 108000;
+     default: return (reg[0x07] & R07_65M_50M) ? 76000 : 65000;
+     }
+}
+
+uint32_t RDA5807M_Sim::Spacing(void) {
+  static const uint8_t kHz[] = { 100, 200, 50, 25 };
+  return kHz[reg[0x03] & 3];
+}
+
+uint16_t RDA5807M_Sim::Channels(void) {
+  return (BandEnd() - BandStart()) / Spacing() + 1;
+}
+
+uint32_t RDA5807M_Sim::Frequency(uint16_t Channel) {
+  return BandStart() + Channel * Spacing();
+}
+
+const RDA5807M_Sim::Station* RDA5807M_Sim::Tuned(uint32_t Frequency) {
+  for(uint8_t i=0; i<count; i++)
+     if (stations[i].Frequency == Frequency)
+        return &stations[i];
+  return 0;
+}
+
+uint8_t RDA5807M_Sim::Rssi(uint32_t Frequency) {
+  // stations fall off by 3dB per 10kHz offset, up to 100kHz away.
+  int rssi = NoiseRssi + (Rand() % 3);
+  for(uint8_t i=0; i<count; i++) {
+     uint32_t f = stations[i].Frequency;
+     uint32_t d = (f > Frequency) ? f - Frequency : Frequency - f;
+     if (d > 100)
+        continue;
+     int r = stations[i].Rssi - (int)(d * 3 / 10);
+     if (r > rssi)
+        rssi = r;
+     }
+  return rssi > 127 ? 127 : rssi;
+}
+
+bool RDA5807M_Sim::IsStation(uint32_t Frequency) {
+  uint8_t seekth = (reg[0x05] >> 8) & 0xF;
+  return (Tuned(Frequency) != 0) and (Rssi(Frequency) >= NoiseRssi + 2 * seekth);
+}
+
+
+/*******************************************************************************
+ * tune and seek
+ ******************************************************************************/
+void RDA5807M_Sim::StartTune(void) {
+  uint64_t start = (now > readyAt) ? now : readyAt;
+  stc     = false;
+  sf      = false;
+  rdsr    = false;
+  fifoCount = 0;
+  busy    = true;
+  seeking = false;
+  failing = false;
+  target  = reg[0x03] >> 6;
+  doneAt  = start + TuneTime;
+}
+
+void RDA5807M_Sim::StartSeek(void) {
+  uint64_t start = (now > readyAt) ? now : readyAt;
+  uint16_t last  = Channels() - 1;
+  bool up        = (reg[0x02] & R02_SEEKUP) > 0;
+  bool stop      = (reg[0x02] & R02_SKMODE) > 0;
+  uint16_t ch    = readchan;
+  uint32_t steps = 0;
+
+  stc     = false;
+  sf      = false;
+  rdsr    = false;
+  fifoCount = 0;
+  busy    = true;
+  seeking = true;
+  failing = true;
+
+  while(steps <= last) {
+     if (up and (ch == last)) {
+        if (stop) break;
+        ch = 0;
+        }
+     else if (not up and (ch == 0)) {
+        if (stop) break;
+        ch = last;
+        }
+     else
+        ch += up ? 1 : -1;
+     steps++;
+     if (ch == readchan)
+        break;
+     if (IsStation(Frequency(ch))) {
+        failing = false;
+        break;
+        }
+     }
+
+  target = ch;
+  doneAt = start + (steps ? steps : 1) * (uint64_t) SeekStepTime;
+}
+
+void RDA5807M_Sim::Update(void) {
+  if (powered and busy and (now >= doneAt)) {
+     busy     = false;
+     readchan = target;
+     stc      = true;
+     sf       = failing;
+     if (seeking)
+        reg[0x02] &= ~R02_SEEK;
+     else
+        reg[0x03] &= ~R03_TUNE;
+     psSegment = 0;
+     rtSegment = 0;
+     nextGroup = now + GroupTime;
+     Pulse(R04_STCIEN);
+     }
+
+  const Station* s = Tuned(Frequency(readchan));
+  bool rds = powered and (not busy) and (now >= readyAt) and
+             (reg[0x02] & R02_RDS_EN) and s and s->PI;
+  if (not rds) {
+     nextGroup = now + GroupTime;
+     return;
+     }
+
+  // only the latest group is kept in the registers (or 16 in the fifo),
+  // older ones are lost.
+  if (now >= nextGroup + 16 * (uint64_t) GroupTime) {
+     uint64_t skip = (now - nextGroup) / GroupTime - 15;
+     if (reg[0x04] & R04_FIFO_EN)
+        FifoOverflows += skip;
+     nextGroup += skip * GroupTime;
+     }
+  while(now >= nextGroup) {
+     NextGroup();
+     nextGroup += GroupTime;
+     Pulse(R04_RDSIEN);
+     }
+}
+
+
+void RDA5807M_Sim::Pulse(uint16_t Enable) {
+  if (handler and (reg[0x04] & Enable) and
+     ((reg[0x04] & R04_GPIO2) == R04_GPIO2_INT))
+     handler(context);
+}
+
+
+/*******************************************************************************
+ * RDS
+ ******************************************************************************/
+void RDA5807M_Sim::NextGroup(void) {
+  const Station* s = Tuned(Frequency(readchan));
+  uint16_t pty = (s->PTY & 0x1F) << 5;
+  uint32_t minutes = nextGroup / 60000000ULL;
+
+  block[0] = s->PI;
+  if (minutes != minute) {
+     // 4A, clock time and date
+     uint32_t mjd  = MJD + minutes / 1440;
+     uint8_t  hour = (minutes / 60) % 24;
+     minute   = minutes;
+     block[1] = (4 << 12) | pty | ((mjd >> 15) & 3);
+     block[2] = ((mjd & 0x7FFF) << 1) | (hour >> 4);
+     block[3] = ((hour & 0xF) << 12) | ((minutes % 60) << 6);
+     }
+  else if (((groups & 3) == 3) and s->RT) {
+     // 2A, RadioText
+     char text[64];
+     uint8_t len = strlen(s->RT);
+     if (len > 64) len = 64;
+     memset(text, ' ', sizeof(text));
+     memcpy(text, s->RT, len);
+     if (len < 64) text[len++] = 0x0D;
+     uint8_t segments = (len + 3) / 4;
+     if (rtSegment >= segments) rtSegment = 0;
+     const char* p = text + 4 * rtSegment;
+     block[1] = (2 << 12) | pty | rtSegment;
+     block[2] = ((uint8_t) p[0] << 8) | (uint8_t) p[1];
+     block[3] = ((uint8_t) p[2] << 8) | (uint8_t) p[3];
+     rtSegment++;
+     }
+  else {
+     // 0A, basic tuning and switching information
+     char ps[8];
+     uint8_t len = s->PS ? strlen(s->PS) : 0;
+     if (len > 8) len = 8;
+     memset(ps, ' ', sizeof(ps));
+     memcpy(ps, s->PS, len);
+     const char* p = ps + 2 * psSegment;
+     bool di = (psSegment == 3) and s->Stereo;
+     block[1] = pty | (1 << 3) | (di << 2) | psSegment;
+     block[2] = 0xE0CD; // no AF
+     block[3] = ((uint8_t) p[0] << 8) | (uint8_t) p[1];
+     psSegment = (psSegment + 1) & 3;
+     }
+
+  uint8_t bler[4];
+  for(int i=0; i<4; i++) {
+     bler[i] = 0;
+     if (BlockErrorRate[i] and ((Rand() % 1000) < BlockErrorRate[i])) {
+        bler[i] = 1 + Rand() % 3;
+        if (bler[i] == 3)
+           block[i] ^= 1 + Rand() % 0xFFFF;
+        }
+     }
+  blera = bler[0];
+  blerb = bler[1];
+  rdsr  = true;
+  groups++;
+
+  if (reg[0x04] & R04_FIFO_EN) {
+     uint8_t depth = (FifoDepth > 16) ? 16 : (FifoDepth ? FifoDepth : 1);
+     if (fifoCount == depth) {
+        // overflow, the oldest group is lost.
+        fifoHead = (fifoHead + 1) & 15;
+        fifoCount--;
+        FifoOverflows++;
+        }
+     Group& g = fifo[(fifoHead + fifoCount) & 15];
+     memcpy(g.block, block, sizeof(block));
+     g.blera = blera;
+     g.blerb = blerb;
+     fifoCount++;
+     Load();
+     }
+}
+
+void RDA5807M_Sim::Load(void) {
+  // in fifo mode, the registers show the oldest queued group.
+  rdsr = fifoCount > 0;
+  if (not rdsr)
+     return;
+  const Group& g = fifo[fifoHead];
+  memcpy(block, g.block, sizeof(block));
+  blera = g.blera;
+  blerb = g.blerb;
+}
+
+
+/*******************************************************************************
+ * registers
+ ******************************************************************************/
+uint16_t RDA5807M_Sim::Status(uint8_t Register) {
+  if (not powered)
+     return 0;
+
+  bool ready = now >= readyAt;
+  uint32_t f = Frequency(readchan);
+  const Station* s = Tuned(f);
+
+  switch(Register) {
+     case 0x0A: {
+        bool rdss = ready and (not busy) and (reg[0x02] & R02_RDS_EN) and s and s->PI;
+        bool st   = ready and (not busy) and s and s->Stereo and
+                    not (reg[0x02] & R02_MONO) and (s->Rssi >= 30);
+        return (rdsr << 15) | (stc << 14) | (sf << 13) | (rdss << 12) |
+               (st << 10) | (readchan & 0x3FF);
+        }
+     case 0x0B: {
+        uint8_t rssi = ready ? Rssi(f) : 0;
+        bool fm_true = ready and (not busy) and IsStation(f);
+        return (rssi << 9) | (fm_true << 8) | (ready << 7) |
+               (blera << 2) | blerb;
+        }
+     default:
+        return block[Register - 0x0C];
+     }
+}
+
+uint16_t RDA5807M_Sim::Register(uint8_t Register) {
+  Register &= 0x0F;
+  if (Register == 0x00)
+     return ChipId;
+  if (Register >= 0x0A)
+     return Status(Register);
+  return reg[Register];
+}
+
+void RDA5807M_Sim::Written(uint8_t Register) {
+  if (Register == 0x02) {
+     if (reg[0x02] & R02_SOFT_RESET) {
+        Reset();
+        return;
+        }
+     if ((reg[0x02] & R02_ENABLE) and not powered) {
+        powered = true;
+        readyAt = now + PowerUpTime;
+        }
+     else if (not (reg[0x02] & R02_ENABLE) and powered) {
+        powered = false;
+        busy    = false;
+        }
+     if (powered and (reg[0x02] & R02_SEEK) and not (busy and seeking))
+        StartSeek();
+     else if (busy and seeking and not (reg[0x02] & R02_SEEK))
+        busy = false;
+     }
+  else if (Register == 0x04) {
+     if ((reg[0x04] & R04_FIFO_CLR) or not (reg[0x04] & R04_FIFO_EN)) {
+        reg[0x04] &= ~R04_FIFO_CLR;
+        fifoCount = 0;
+        rdsr      = false;
+        }
+     }
+  else if (Register == 0x03) {
+     if (powered and (reg[0x03] & R03_TUNE))
+        StartTune();
+     }
+}
+
+void RDA5807M_Sim::Transfer(uint8_t Bytes) {
+  // start, address, data bytes with ACK each, stop.
+  Transactions++;
+  BusBytes += Bytes + 1;
+  now += ((Bytes + 1) * 9 + 2) * 1000000ULL / BusClock;
+  Update();
+}
+
+bool RDA5807M_Sim::Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+  if ((Address != 0x10) and (Address != 0x11))
+     return false;
+  Transfer(Count);
+
+  uint8_t r = 0x02;
+  if (Address == 0x11) {
+     if (Count == 0)
+        return true;
+     r = index = *Data++ & 0x0F;
+     Count--;
+     }
+
+  uint8_t first = r, last = r;
+  for(; Count >= 2; Count -= 2, Data += 2) {
+     if ((r >= 0x02) and (r <= 0x08))
+        reg[r] = (Data[0] << 8) | Data[1];
+     last = r;
+     r = (r + 1) & 0x0F;
+     }
+
+  if ((first <= 0x02) and (last >= 0x02)) Written(0x02);
+  if ((first <= 0x03) and (last >= 0x03)) Written(0x03);
+  if ((first <= 0x04) and (last >= 0x04)) Written(0x04);
+  return true;
+}
+
+bool RDA5807M_Sim::Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+  if ((Address != 0x10) and (Address != 0x11))
+     return false;
+  Transfer(Count);
+
+  uint8_t r = (Address == 0x10) ? 0x0A : index;
+  for(; Count >= 2; Count -= 2, Data += 2) {
+     uint16_t v = Register(r);
+     if ((r == 0x0F) and rdsr) {
+        // group consumed
+        rdsr = false;
+        if (reg[0x04] & R04_FIFO_EN) {
+           fifoHead = (fifoHead + 1) & 15;
+           fifoCount--;
+           Load();
+           }
+        }
+     Data[0] = v >> 8;
+     Data[1] = v & 0xFF;
+     r = (r + 1) & 0x0F;
+     }
+  if (Count)
+     *Data = Register(r) >> 8;
+  return true;
+}
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_SIM_H
+#define RDA5807M_SIM_H
+
+#include <stdint.h> // uint{8,16,32}_t
+
+/*******************************************************************************
+ * Software model of the RDA5807M, for developing and benchmarking against the
+ * driver without hardware.
+ *
+ * - writable registers 0x02..0x08 and status registers 0x0A..0x0F, using the
+ *   bit layout of the data sheet (and the driver's Set() and Get())
+ * - sequential access at 0x10 and random access at 0x11
+ * - tune and seek with STC/SF latency
+ * - a synthetic band, given as a list of stations with RSSI and stereo
+ * - RDS groups at 11.4 groups/s (PS, RadioText and CT) with configurable
+ *   block error rates
+ *
+ * The model has it's own clock. It advances by the duration of every bus
+ * transaction (at BusClock), by PollTime on every Millis() call and by
+ * Advance(). Tests therefore run as fast as the CPU allows.
+ *
+ * Use RDA5807M_SimBus as the driver's transport:
+ *   RDA5807M_Sim chip;
+ *   RDA5807M_Driver<RDA5807M_SimBus> radio(chip);
+ ******************************************************************************/
+class RDA5807M_Sim {
+public:
+  struct Station {
+    uint32_t Frequency;  // kHz, ie. 87500
+    uint8_t  Rssi;       // 0..127
+    bool     Stereo;
+    uint16_t PI;         // 0 = no RDS
+    uint8_t  PTY;
+    const char* PS;      // up to 8 chars
+    const char* RT;      // up to 64 chars, may be 0
+  };
+
+  /* model timing, in microseconds. */
+  uint32_t PowerUpTime;  // ENABLE until FM_READY
+  uint32_t TuneTime;     // TUNE until STC
+  uint32_t SeekStepTime; // per channel stepped during seek
+  uint32_t GroupTime;    // RDS group period, 1/11.4s
+  uint32_t PollTime;     // added on every Millis() call
+  uint32_t BusClock;     // I2C clock in Hz
+  uint8_t  FifoDepth;    // RDS fifo depth in groups, max. 16
+
+  /* per block error rate in 1/1000, block A..D.
+   * Errors are reported in BLERA/BLERB for block A and B. An error
+   * level of 3 (not correctable) corrupts the block data.
+   */
+  uint16_t BlockErrorRate[4];
+
+  /* GPIO2 interrupt output, see OnInterrupt(). */
+  typedef void (*Handler)(void* Context);
+
+  /* noise floor RSSI of empty channels. */
+  uint8_t NoiseRssi;
+
+  /* Modified Julian Date at model time zero, used for CT groups. */
+  uint32_t MJD;
+
+  /* bus statistics, including address bytes. */
+  uint32_t Transactions;
+  uint32_t BusBytes;
+  uint32_t FifoOverflows;   // RDS groups lost in fifo mode
+
+private:
+  uint16_t reg[0x10];
+  uint8_t  index;           // register pointer for reads
+  uint64_t now;             // us
+  const Station* stations;
+  uint8_t  count;
+  uint32_t random;
+
+  bool     powered;
+  uint64_t readyAt;
+  bool     busy;
+  uint64_t doneAt;
+  uint16_t target;          // channel reached when busy ends
+  bool     seeking, failing;
+  uint16_t readchan;
+  bool     stc, sf;
+
+  bool     rdsr;
+  uint16_t block[4];
+  uint8_t  blera, blerb;
+  struct Group {
+    uint16_t block[4];
+    uint8_t  blera, blerb;
+    } fifo[16];
+  uint8_t  fifoHead, fifoCount;
+  uint64_t nextGroup;
+  uint32_t groups;
+  uint8_t  psSegment, rtSegment;
+  uint32_t minute;          // of the last CT group
+  Handler  handler;
+  void*    context;
+
+  void     Reset(void);
+  void     Update(void);
+  void     Transfer(uint8_t Bytes);
+  void     Written(uint8_t Register);
+  uint16_t Status(uint8_t Register);
+  uint32_t Rand(void);
+
+  uint32_t BandStart(void);
+  uint32_t BandEnd(void);
+  uint32_t Spacing(void);
+  uint32_t Frequency(uint16_t Channel);
+  const Station* Tuned(uint32_t Frequency);
+  uint8_t  Rssi(uint32_t Frequency);
+  bool     IsStation(uint32_t Frequency);
+  uint16_t Channels(void);
+  void     StartTune(void);
+  void     StartSeek(void);
+  void     NextGroup(void);
+  void     Load(void);
+  void     Pulse(uint16_t Enable);
+
+public:
+  RDA5807M_Sim(void);
+
+  /* the synthetic band, the list is not copied. */
+  void Stations(const Station* List, uint8_t Count);
+
+  /* model time */
+  unsigned long Millis(void);
+  uint64_t Micros(void) const { return now; }
+  void Advance(uint32_t Microseconds);
+
+  /* Handler is called on every GPIO2 interrupt pulse, ie. STC with STCIEN or
+   * a new RDS group with RDSIEN set and GPIO2 configured as interrupt output.
+   * It may call the driver's Interrupt().
+   */
+  void OnInterrupt(Handler H, void* Context) { handler = H; context = Context; }
+
+  /* raw register access, without bus timing. */
+  uint16_t Register(uint8_t Register);
+
+  /* number of RDS groups sent since power up. */
+  uint32_t Groups(void) const { return groups; }
+
+  /* I2C device side. */
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count);
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count);
+};
+
+
+/*******************************************************************************
+ * Transport for RDA5807M_Driver, connected to a RDA5807M_Sim.
+ ******************************************************************************/
+class RDA5807M_SimBus {
+private:
+  RDA5807M_Sim* sim;
+public:
+  RDA5807M_SimBus(RDA5807M_Sim& Sim) : sim(&Sim) {}
+
+  RDA5807M_Sim& Sim(void) { return *sim; }
+
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+    return sim->Write(Address, Data, Count);
+  }
+
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    return sim->Read(Address, Data, Count);
+  }
+
+  bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+                 uint8_t* In, uint8_t InCount) {
+    return sim->Write(Address, Out, OutCount) and sim->Read(Address, In, InCount);
+  }
+
+  unsigned long Millis(void) {
+    return sim->Millis();
+  }
+
+  unsigned long Micros(void) {
+    return sim->Micros();
+  }
+
+  void Print(const char*) {}
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_STATUS_H
+#define RDA5807M_STATUS_H
+
+#include <stdint.h> // uint{8,16,32}_t
+
+/*******************************************************************************
+ * One received RDS group.
+ ******************************************************************************/
+struct RDA5807M_Group {
+  uint16_t Block[4];     // A..D
+  uint8_t  BLERA;        // block error level A (0..3)
+  uint8_t  BLERB;        // block error level B (0..3)
+  uint16_t Channel;      // READCHAN at reception
+  unsigned long Time;    // ms, Transport::Millis() of the read
+};
+
+
+/*******************************************************************************
+ * One read of the status registers 0x0A..0x0F.
+ * All fields are decoded from the same bus transaction, so they are
+ * consistent with each other. The accessors follow the RDA5807M getters
+ * of the same name.
+ ******************************************************************************/
+struct RDA5807M_Status {
+  uint16_t Rd[6];        // 0x0A..0x0F, as read
+  unsigned long Time;    // ms, Transport::Millis() of the read
+  uint32_t Sequence;     // incremented on every status read
+
+  bool     RDS_ready(void)         const { return (Rd[0] & 0x8000) > 0; }
+  bool     TuneComplete(void)      const { return (Rd[0] & 0x4000) > 0; }
+  bool     SeekFail(void)          const { return (Rd[0] & 0x2000) > 0; }
+  bool     RDS_sync(void)          const { return (Rd[0] & 0x1000) > 0; }
+  bool     RDS_BlockE(void)        const { return (Rd[0] & 0x800 ) > 0; }
+  bool     StereoIndicator(void)   const { return (Rd[0] & 0x400 ) > 0; }
+  uint16_t ChannelNumber(void)     const { return  Rd[0] & 0x3FF; }
+
+  uint8_t  SignalStrength(void)    const { return  Rd[1] >> 9; }
+  bool     IsStation(void)         const { return (Rd[1] & 0x100 ) > 0; }
+  bool     FM_ready(void)          const { return (Rd[1] & 0x80  ) > 0; }
+  bool     RDS_is_RDBS(void)       const { return (Rd[1] & 0x10  ) > 0; }
+  uint8_t  RDS_BlockErrors_A(void) const { return (Rd[1] & 0xC   ) >> 2; }
+  uint8_t  RDS_BlockErrors_B(void) const { return (Rd[1] & 0x3   ); }
+
+  uint16_t RDS_BlockA(void)        const { return Rd[2]; }
+  uint16_t RDS_BlockB(void)        const { return Rd[3]; }
+  uint16_t RDS_BlockC(void)        const { return Rd[4]; }
+  uint16_t RDS_BlockD(void)        const { return Rd[5]; }
+
+  RDA5807M_Group Group(void) const {
+    RDA5807M_Group g = { { Rd[2], Rd[3], Rd[4], Rd[5] },
+                         RDS_BlockErrors_A(), RDS_BlockErrors_B(),
+                         ChannelNumber(), Time };
+    return g;
+  }
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#include <string.h>
+#include "RDA5807M_TMC.h"
+
+RDA5807M_TMC::RDA5807M_TMC(void) {
+  Reset();
+}
+
+void RDA5807M_TMC::Reset(void) {
+  count      = 0;
+  pending    = false;
+  assembling = false;
+  memset(last, 0, sizeof(last));
+  Groups     = 0;
+  Duplicates = 0;
+  System     = 0;
+  Incomplete = 0;
+  Evicted    = 0;
+  Expired    = 0;
+}
+
+unsigned long RDA5807M_TMC::Persistence(const Message& M) {
+  // duration and persistence, ISO 14819-1 table 5, in minutes.
+  // 7 (rest of the day) is taken as 24h.
+  static const uint16_t minutes[8] = { 15, 15, 30, 60, 120, 180, 240, 1440 };
+  return minutes[M.Duration & 7] * 60000UL;
+}
+
+void RDA5807M_TMC::Append(Message& M, uint32_t Value, uint8_t Bits) {
+  while(Bits--) {
+     if (M.Bits >= 8 * sizeof(M.FreeFormat))
+        return;
+     if (Value & ((uint32_t) 1 << Bits))
+        M.FreeFormat[M.Bits / 8] |= 0x80 >> (M.Bits % 8);
+     M.Bits++;
+     }
+}
+
+bool RDA5807M_TMC::Decode(const RDA5807M_Group& G) {
+  uint16_t B = G.Block[1], C = G.Block[2], D = G.Block[3];
+
+  if (((B >> 11) != 0x10) or G.BLERA or G.BLERB)
+     return false; // not 8A, or not error free
+  Groups++;
+
+  if (B & 0x10) {
+     // T = 1: tuning and system information
+     System++;
+     return false;
+     }
+
+  bool repeated = (B == last[0]) and (C == last[1]) and (D == last[2]);
+  last[0] = B;
+  last[1] = C;
+  last[2] = D;
+
+  if (B & 0x08) {
+     // F = 1: single group message, accepted on it's repetition.
+     if (not repeated) {
+        pending = true;
+        return false;
+        }
+     if (not pending) {
+        Duplicates++;
+        return false;
+        }
+     pending = false;
+
+     Message m;
+     memset(&m, 0, sizeof(m));
+     m.Location  = D;
+     m.Event     = C & 0x7FF;
+     m.Extent    = (C >> 11) & 7;
+     m.Direction = (C & 0x4000) > 0;
+     m.Diversion = (C & 0x8000) > 0;
+     m.Duration  = B & 7;
+     m.Groups    = 1;
+     m.Received  = m.Updated = G.Time;
+     return Store(m);
+     }
+
+  // F = 0: multi group message
+  pending = false;
+  if (repeated) {
+     Duplicates++;
+     return false;
+     }
+
+  uint8_t index = B & 7;
+  if (C & 0x8000) {
+     // first group
+     if (assembling)
+        Incomplete++;
+     memset(&multi, 0, sizeof(multi));
+     multi.Location  = D;
+     multi.Event     = C & 0x7FF;
+     multi.Extent    = (C >> 11) & 7;
+     multi.Direction = (C & 0x4000) > 0;
+     multi.Groups    = 1;
+     multi.Received  = multi.Updated = G.Time;
+     ci         = index;
+     gsi        = 0xFF;
+     assembling = true;
+     return false;
+     }
+
+  if (not assembling or (index != ci))
+     return false;
+
+  // subsequent group: SG (second group) and GSI (groups remaining).
+  bool second    = (C & 0x4000) > 0;
+  uint8_t remain = (C >> 12) & 3;
+  if ((second != (multi.Groups == 1)) or (not second and (remain != gsi))) {
+     Incomplete++;
+     assembling = false;
+     return false;
+     }
+
+  Append(multi, ((uint32_t) (C & 0xFFF) << 16) | D, 28);
+  multi.Groups++;
+  if (remain == 0) {
+     assembling = false;
+     return Store(multi);
+     }
+  gsi = remain - 1;
+  return false;
+}
+
+bool RDA5807M_TMC::Store(const Message& M) {
+  uint8_t oldest = 0;
+  for(uint8_t i=0; i<count; i++) {
+     Message& s = store[i];
+     if ((s.Location == M.Location) and (s.Direction == M.Direction) and
+         (s.Event == M.Event)) {
+        // an update of a stored message.
+        unsigned long received = s.Received;
+        uint16_t repeats = s.Repeats;
+        s = M;
+        s.Received = received;
+        s.Repeats  = repeats + 1;
+        return true;
+        }
+     if ((M.Updated - s.Updated) > (M.Updated - store[oldest].Updated))
+        oldest = i;
+     }
+
+  if (count < Capacity) {
+     store[count++] = M;
+     return true;
+     }
+
+  Expire(M.Updated);
+  if (count < Capacity)
+     store[count++] = M;
+  else {
+     store[oldest] = M;
+     Evicted++;
+     }
+  return true;
+}
+
+void RDA5807M_TMC::Expire(unsigned long Now) {
+  for(uint8_t i=0; i<count;) {
+     if ((Now - store[i].Updated) >= Persistence(store[i])) {
+        store[i] = store[--count];
+        Expired++;
+        }
+     else
+        i++;
+     }
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_TMC_H
+#define RDA5807M_TMC_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M_Status.h"
+
+/*******************************************************************************
+ * Compile time switch, to be given as compiler flag (ie. -DRDA5807M_TMC_MESSAGES=32)
+ *
+ *   RDA5807M_TMC_MESSAGES  N: size of the message store, max 255. Default 8,
+ *                             approx. 34 bytes per message.
+ ******************************************************************************/
+#ifndef RDA5807M_TMC_MESSAGES
+#define RDA5807M_TMC_MESSAGES 8
+#endif
+
+
+/*******************************************************************************
+ * One RDS-TMC message (ISO 14819-1).
+ ******************************************************************************/
+struct RDA5807M_TMC_Message {
+  uint16_t Location;       // location code
+  uint16_t Event;          // event code, 11 bit
+  uint8_t  Extent;         // 0..7
+  bool     Direction;      // true = negative direction
+  bool     Diversion;      // diversion advice (single group)
+  uint8_t  Duration;       // duration and persistence (single group), 0..7
+  uint8_t  Groups;         // 1..5
+  uint8_t  Bits;           // valid bits in FreeFormat
+  uint8_t  FreeFormat[14]; // 28 bits per subsequent group, msb first
+  uint16_t Repeats;        // receptions after the first one
+  unsigned long Received;  // ms, first reception
+  unsigned long Updated;   // ms, last reception
+};
+
+
+/*******************************************************************************
+ * Streaming decoder for RDS-TMC groups 8A, fed one RDA5807M_Group at a time.
+ *
+ * - single group messages are accepted, once received twice in a row, as
+ *   TMC transmits them (at least) twice
+ * - multi group messages are reassembled from the first group and up to
+ *   four subsequent groups of the same continuity index, which have to
+ *   arrive in order with their group sequence identifier counting down
+ * - identical repetitions of a group are skipped, messages already stored
+ *   (same location, direction and event) are updated in place
+ * - the store has a fixed size; when full, expired messages are evicted
+ *   first, then the one not received for the longest time
+ *
+ * Only 8A groups with error free blocks A and B are used; the chip doesn't
+ * report errors of block C and D, those are covered by the repetition.
+ * Decode() costs one compare of the last group per group, plus one pass
+ * over the store per accepted message.
+ ******************************************************************************/
+class RDA5807M_TMC {
+public:
+  typedef RDA5807M_TMC_Message Message;
+  static constexpr uint8_t Capacity = RDA5807M_TMC_MESSAGES;
+
+  RDA5807M_TMC(void);
+
+  /* forget everything, ie. after tuning to another channel. */
+  void Reset(void);
+
+  /* Decode one group. Returns true, if a message was stored or updated. */
+  bool Decode(const RDA5807M_Group& G);
+
+  /* stored messages, in no particular order. */
+  uint8_t Size(void) const { return count; }
+  const Message& operator[](uint8_t Index) const { return store[Index]; }
+
+  /* remove messages, whose persistence ended at Now (ms). */
+  void Expire(unsigned long Now);
+
+  /* persistence of a message in ms, 15min for multi group messages. */
+  static unsigned long Persistence(const Message& M);
+
+  /* statistics */
+  uint32_t Groups;       // 8A groups decoded
+  uint32_t Duplicates;   // identical repetitions skipped
+  uint32_t System;       // tuning and system information groups
+  uint32_t Incomplete;   // multi group messages dropped
+  uint32_t Evicted;      // messages removed from a full store
+  uint32_t Expired;      // messages removed by Expire()
+
+private:
+  Message store[Capacity];
+  uint8_t count;
+
+  uint16_t last[3];      // blocks B..D of the previous 8A group
+  bool     pending;      // last[] holds an unconfirmed single group
+
+  Message  multi;        // multi group message being assembled
+  uint8_t  ci;           // it's continuity index
+  uint8_t  gsi;          // group sequence identifier expected next
+  bool     assembling;
+
+  bool Store(const Message& M);
+  void Append(Message& M, uint32_t Value, uint8_t Bits);
+};
+
+#endif
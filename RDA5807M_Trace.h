@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_TRACE_H
+#define RDA5807M_TRACE_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include <stdio.h>
+
+/*******************************************************************************
+ * Compile time switch, to be given as compiler flag (ie. -DRDA5807M_DEBUG=1)
+ *
+ *   RDA5807M_DEBUG  1: print every register commit and status read as text
+ *                      through the transport's Print(). Default 0, no output.
+ *
+ * The driver on Arduino's Wire is compiled once, in RDA5807M.cpp, so the
+ * flag has to be set for the library build, not by a #define in the sketch.
+ *
+ * Register access tracing doesn't depend on a switch, it's a property of the
+ * transport, see RDA5807M_Traced.
+ ******************************************************************************/
+#ifndef RDA5807M_DEBUG
+#define RDA5807M_DEBUG 0
+#endif
+
+
+/*******************************************************************************
+ * Fixed size ring buffer of register accesses, oldest entries are overwritten.
+ ******************************************************************************/
+template<uint16_t N>
+class RDA5807M_Trace {
+public:
+  enum { Read = 1, Burst = 2 };
+
+  struct Record {
+    uint32_t Time;      // us, Transport::Micros() at start of transaction
+    uint16_t Value;
+    uint16_t Duration;  // us, saturated at 65535
+    uint8_t  Register;
+    uint8_t  Flags;     // Read, Burst
+  };
+
+private:
+  static_assert((N & (N - 1)) == 0, "RDA5807M_Trace: N must be a power of two");
+  Record records[N];
+  uint16_t head;
+  uint16_t count;
+
+public:
+  RDA5807M_Trace(void) : head(0), count(0) {}
+
+  void Add(uint8_t Register, uint16_t Value, uint8_t Flags,
+           uint32_t Time, uint32_t Duration) {
+    Record& r = records[head];
+    r.Time     = Time;
+    r.Value    = Value;
+    r.Duration = Duration > 0xFFFF ? 0xFFFF : Duration;
+    r.Register = Register;
+    r.Flags    = Flags;
+    head = (head + 1) & (N - 1);
+    if (count < N)
+       count++;
+  }
+
+  /* number of records, at most N. */
+  uint16_t Size(void) const { return count; }
+
+  /* record i, 0 is the oldest one. */
+  const Record& operator[](uint16_t i) const {
+    return records[(head - count + i) & (N - 1)];
+  }
+
+  void Clear(void) { count = 0; }
+
+  /* Prints all records, oldest first, as text lines
+   *   <time us> <R|W> <register> <value> <duration us>
+   * using Out.Print(const char*), ie. the driver's transport.
+   */
+  template<class Printer>
+  void Dump(Printer& Out) const {
+    for(uint16_t i=0; i<count; i++) {
+       const Record& r = (*this)[i];
+       char buf[40];
+       snprintf(buf, sizeof(buf), "%lu %c%s %02X %04X %u\n",
+                (unsigned long) r.Time,
+                (r.Flags & Read) ? 'R' : 'W',
+                (r.Flags & Burst) ? "+" : "",
+                r.Register, r.Value, r.Duration);
+       Out.Print(buf);
+       }
+  }
+};
+
+
+/*******************************************************************************
+ * A transport recording the last N register accesses of it's driver into a
+ * RDA5807M_Trace. Needs Transport::Micros().
+ *
+ *   RDA5807M_Driver<RDA5807M_Traced<RDA5807M_Wire, 64>> radio(Wire);
+ *   ...
+ *   radio.Bus().Trace().Dump(radio.Bus());
+ *
+ * The driver on a traced transport is a type of it's own, so the trace never
+ * changes the layout of the driver on the untraced one.
+ ******************************************************************************/
+template<class Transport, uint16_t N>
+class RDA5807M_Traced : public Transport {
+public:
+  typedef RDA5807M_Trace<N> TraceBuffer;
+
+  using Transport::Transport;
+  RDA5807M_Traced(void) {}
+  RDA5807M_Traced(const Transport& Bus) : Transport(Bus) {}
+
+  TraceBuffer& Trace(void) { return trace; }
+  const TraceBuffer& Trace(void) const { return trace; }
+private:
+  TraceBuffer trace;
+};
+
+
+/*******************************************************************************
+ * Used by the driver: adds records, if Transport is a RDA5807M_Traced, and
+ * does nothing otherwise.
+ ******************************************************************************/
+template<class Transport>
+struct RDA5807M_Tracer {
+  enum { On = 0, Read = 1, Burst = 2 };
+  static unsigned long Micros(Transport&) { return 0; }
+  static void Add(Transport&, uint8_t, uint16_t, uint8_t, uint32_t, uint32_t) {}
+};
+
+template<class Transport, uint16_t N>
+struct RDA5807M_Tracer<RDA5807M_Traced<Transport, N>> {
+  typedef RDA5807M_Traced<Transport, N> Bus;
+  enum { On = 1, Read = RDA5807M_Trace<N>::Read, Burst = RDA5807M_Trace<N>::Burst };
+  static unsigned long Micros(Bus& B) { return B.Micros(); }
+  static void Add(Bus& B, uint8_t Register, uint16_t Value, uint8_t Flags,
+                  uint32_t Time, uint32_t Duration) {
+    B.Trace().Add(Register, Value, Flags, Time, Duration);
+  }
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_TUNERS_H
+#define RDA5807M_TUNERS_H
+
+#include <stdint.h> // uint{8,16,32}_t
+#include "RDA5807M.h"
+#include "RDA5807M_Scan.h"
+
+/*******************************************************************************
+ * A set of N tuners, each with it's own driver and transport (I2C port or
+ * mux channel, see RDA5807M_Wire), and a band scan split across them.
+ *
+ * Every tuner scans a contiguous part of the band into it's own table of
+ * MaxSize entries. Step() advances all scanners, so while one tuner waits
+ * for STC or it's dwell time, the others use the bus. When all are done,
+ * the tables are merged into one sorted by channel, replacing the weakest
+ * stations as a single RDA5807M_Scanner would (see RDA5807M_Insert()), so
+ * the result is the same as of one tuner.
+ *
+ * All tuners have to use the same Band() and ChannelSpacing().
+ *
+ *   RDA5807M_Driver<RDA5807M_Wire> a(Wire), b(Wire1);
+ *   RDA5807M_Tuners<RDA5807M_Wire, 2> tuners(a, b);
+ *   RDA5807M_Station table[32];
+ *   tuners.Start(table, 32);
+ *   while(tuners.Step()) {}
+ ******************************************************************************/
+template<class Transport, uint8_t N, uint8_t MaxSize = 32>
+class RDA5807M_Tuners {
+public:
+  typedef RDA5807M_Driver<Transport> Driver;
+  typedef RDA5807M_Scanner<Transport> Scanner;
+
+  template<class... Drivers>
+  RDA5807M_Tuners(Drivers&... Radios) : radio{ &Radios... }, scanner{ Radios... },
+    table(0), size(0), count(0), running(false) {
+    static_assert(sizeof...(Radios) == N, "RDA5807M_Tuners: N drivers needed");
+  }
+
+  /* number of tuners */
+  uint8_t Size(void) const { return N; }
+
+  /* tuner n and it's scanner, ie. for MinRssi and Dwell. */
+  Driver&  Tuner(uint8_t n) { return *radio[n]; }
+  Scanner& Scan(uint8_t n) { return scanner[n]; }
+
+  /* Starts a scan of the band into Table, max. MaxSize entries.
+   * Returns false, if a tuner is busy or the tuners use different bands.
+   */
+  bool Start(RDA5807M_Station* Table, uint8_t Size) {
+    if (running or not Size or (Size > MaxSize))
+       return false;
+    for(uint8_t n=0; n<N; n++)
+       if (radio[n]->Busy() or (radio[n]->Channels() != radio[0]->Channels()) or
+           (radio[n]->BandStart() != radio[0]->BandStart()))
+          return false;
+
+    table = Table;
+    size  = Size;
+    count = 0;
+    for(uint8_t n=0; n<N; n++)
+       if (First(n) < First(n + 1))
+          scanner[n].Start(scratch[n], size, First(n), First(n + 1) - 1);
+    running = true;
+    return true;
+  }
+
+  /* Advances all scanners. Returns true, while the scan is running. */
+  bool Step(void) {
+    if (not running)
+       return false;
+    bool busy = false;
+    for(uint8_t n=0; n<N; n++)
+       busy |= scanner[n].Step();
+    if (not busy) {
+       Merge();
+       running = false;
+       }
+    return running;
+  }
+
+  bool Busy(void) const { return running; }
+
+  /* stations in the table, after the scan. */
+  uint8_t Found(void) const { return count; }
+
+  /* ms of the last complete scan, ie. of the slowest tuner. */
+  unsigned long Duration(void) const {
+    unsigned long d = 0;
+    for(uint8_t n=0; n<N; n++)
+       if (scanner[n].Duration() > d)
+          d = scanner[n].Duration();
+    return d;
+  }
+
+private:
+  Driver*  radio[N];
+  Scanner  scanner[N];
+  RDA5807M_Station scratch[N][MaxSize];
+  RDA5807M_Station* table;
+  uint8_t  size;
+  uint8_t  count;
+  bool     running;
+
+  // first channel of tuner n.
+  uint16_t First(uint8_t n) const { return (uint32_t) radio[0]->Channels() * n / N; }
+
+  void Merge(void) {
+    // the tables ascend by channel.
+    for(uint8_t n=0; n<N; n++)
+       for(uint8_t i=0; (First(n) < First(n + 1)) and (i < scanner[n].Found()); i++)
+          RDA5807M_Insert(table, size, count, scratch[n][i]);
+  }
+};
+
+#endif
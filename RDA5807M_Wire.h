@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_WIRE_H
+#define RDA5807M_WIRE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/*******************************************************************************
+ * Transport for RDA5807M_Driver on top of the Arduino Wire library.
+ * By default the global Wire object is used, any other TwoWire instance
+ * may be given instead, ie. a second I2C port.
+ *
+ * Several chips on one bus (they share the address) need an I2C mux like the
+ * TCA9548A; give it's address and the channel of the chip. The channel is
+ * selected before every transaction, so only one mux per bus is supported.
+ ******************************************************************************/
+class RDA5807M_Wire {
+private:
+  TwoWire* wire;
+  uint8_t  mux;      // 0 = none
+  uint8_t  channel;
+
+  bool Select(void) {
+    if (not mux)
+       return true;
+    wire->beginTransmission(mux);
+    wire->write((uint8_t) (1 << channel));
+    return wire->endTransmission() == 0;
+  }
+public:
+  RDA5807M_Wire(TwoWire& Bus = Wire) : wire(&Bus), mux(0), channel(0) {}
+
+  RDA5807M_Wire(TwoWire& Bus, uint8_t MuxAddress, uint8_t MuxChannel) :
+    wire(&Bus), mux(MuxAddress), channel(MuxChannel & 7) {}
+
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+    if (not Select())
+       return false;
+    wire->beginTransmission(Address);
+    wire->write(Data, Count);
+    return wire->endTransmission() == 0;
+  }
+
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    if (not Select())
+       return false;
+    if (wire->requestFrom((int) Address, (int) Count) < Count)
+       return false;
+    while(Count--)
+       *Data++ = wire->read();
+    return true;
+  }
+
+  bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+                 uint8_t* In, uint8_t InCount) {
+    if (not Select())
+       return false;
+    wire->beginTransmission(Address);
+    wire->write(Out, OutCount);
+    if (wire->endTransmission(false) != 0)
+       return false;
+    if (wire->requestFrom((int) Address, (int) InCount) < InCount)
+       return false;
+    while(InCount--)
+       *In++ = wire->read();
+    return true;
+  }
+
+  unsigned long Millis(void) {
+    return millis();
+  }
+
+  unsigned long Micros(void) {
+    return micros();
+  }
+
+  void Print(const char* s) {
+    Serial.print(s);
+  }
+};
+
+#endif
@@ -0,0 +1,997 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_IMPL_H
+#define RDA5807M_IMPL_H
+
+/*******************************************************************************
+ * RDA5807M_Driver member definitions, included by RDA5807M.h.
+ ******************************************************************************/
+#include <stdio.h>
+
+/* Status words (0x0A..) to read for TuneStatus, SignalStatus and RDSStatus.
+ */
+static constexpr uint8_t RDA5807M_Words[3] = { 1, 2, 6 };
+
+template<class Transport>
+RDA5807M_Driver<Transport>::RDA5807M_Driver(const Transport& Bus) : bus(Bus),
+  CHIPID(0),bootTime(0),dirty(0x7F),status(),readAt(),maxAge(),tuning(false),
+  lastCommit(),batch(0),staged(false),forced(false),
+  irq(false),useIrq(false),startedAt(0),gpio2(0),asyncDone(0),asyncContext(0),
+  rdsEmptyAt(0),rdsPhase(0),rdsBalance(0),rdsLost(0),
+  recorder(0),recordContext(0) {
+  for(int i=0; i<7; i++)
+     Wr[i] = RDA5807M_Reg::Defaults[i];
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Begin(const RDA5807M_Image& Image, unsigned long Timeout) {
+  for(int i=0; i<7; i++)
+     Wr[i] = Image.Wr[i];
+  unsigned long start = bus.Millis();
+  Set(Wr, 7);
+  dirty = 0;
+  staged = forced = false;
+  tuning = Field(RDA5807M_Reg::TUNE);
+
+  unsigned long now, last = start;
+  while(((now = bus.Millis()) - start) < Timeout) {
+     // poll at most once per ms
+     if ((now == last) or not Read(RDA5807M_Words[SignalStatus]))
+        continue;
+     last = now;
+     if (status.FM_ready() and (status.TuneComplete() or not tuning)) {
+        // the chip clears TUNE by itself.
+        Wr[1] &= ~RDA5807M_Reg::TUNE.Mask();
+        bootTime = bus.Millis() - start;
+        return true;
+        }
+     }
+  return false;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Attach(void) {
+  using namespace RDA5807M_Reg;
+  uint8_t reg = 0x02;
+  uint8_t buf[2 * 7];
+  unsigned long start = Tracer::Micros(bus);
+  if (not bus.WriteRead(Address + 1, &reg, 1, buf, sizeof(buf)))
+     return false;
+  for(int i=0; i<7; i++)
+     Wr[i] = (buf[2*i] << 8) | buf[2*i+1];
+  if (Tracer::On) {
+     unsigned long duration = Tracer::Micros(bus) - start;
+     for(int i=0; i<7; i++)
+        Tracer::Add(bus, 0x02 + i, Wr[i], Tracer::Read | Tracer::Burst, start, duration);
+     }
+
+  // actions must not be repeated by the next write of their register.
+  for(int i=0; i<7; i++)
+     Wr[i] &= ~Triggers[i];
+  dirty = 0;
+  staged = forced = false;
+  tuning = false;
+  // interrupts left on: GPIO2 is their output, the mode set before is
+  // unknown; the power up default (high impedance) is restored without.
+  useIrq = Field(STCIEN);
+  irq    = false;
+  gpio2  = (Field(STCIEN) or Field(RDSIEN)) ? 0 : Field(GPIO2);
+
+  if (not Field(ENABLE) or not Read(RDA5807M_Words[TuneStatus]))
+     return false;
+  // CHAN is not updated by a seek, the current channel is READCHAN.
+  Wr[1] = With(Wr[1], CHAN, status.ChannelNumber());
+  return true;
+}
+
+template<class Transport>
+unsigned RDA5807M_Driver<Transport>::ChipId(void) {
+  if (CHIPID == 0)
+     CHIPID = Get(0x00);
+  return CHIPID;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::RDS_ready(void) {
+  Get(RDSStatus);
+  return status.RDS_ready();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::TuneComplete(void) {
+  Get(TuneStatus);
+  return status.TuneComplete();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::SeekFail(void) {
+  Get(TuneStatus);
+  return status.SeekFail();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::RDS_sync(void) {
+  Get(RDSStatus);
+  return status.RDS_sync();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::RDS_BlockE(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockE();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::StereoIndicator(void) {
+  Get(SignalStatus);
+  return status.StereoIndicator();
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::ChannelNumber(void) {
+  Get(TuneStatus);
+  return status.ChannelNumber();
+}
+
+template<class Transport>
+uint8_t RDA5807M_Driver<Transport>::SignalStrength(void) {
+  Get(SignalStatus);
+  return status.SignalStrength();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::IsStation(void) {
+  Get(SignalStatus);
+  return status.IsStation();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::FM_ready(void) {
+  Get(SignalStatus);
+  return status.FM_ready();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::RDS_is_RDBS(void) {
+  Get(RDSStatus);
+  return status.RDS_is_RDBS();
+}
+
+template<class Transport>
+uint8_t RDA5807M_Driver<Transport>::RDS_BlockErrors_A(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockErrors_A();
+}
+
+template<class Transport>
+uint8_t RDA5807M_Driver<Transport>::RDS_BlockErrors_B(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockErrors_B();
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::RDS_BlockA(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockA();
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::RDS_BlockB(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockB();
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::RDS_BlockC(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockC();
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::RDS_BlockD(void) {
+  Get(RDSStatus);
+  return status.RDS_BlockD();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::AudioEnable(bool On) {
+  Put(RDA5807M_Reg::DHIZ, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Muted(bool On) {
+  Put(RDA5807M_Reg::DMUTE, not On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Mono(bool On) {
+  Put(RDA5807M_Reg::MONO, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::BassBoost(bool On) {
+  Put(RDA5807M_Reg::BASS, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Clock_Always_On(bool On) {
+  Put(RDA5807M_Reg::RCLK_NON_CALIBRATE_MODE, not On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Clock_Direct(bool On) {
+  Put(RDA5807M_Reg::RCLK_DIRECT_INPUT_MODE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SeekStopBandlimits(bool On) {
+  Put(RDA5807M_Reg::SKMODE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Seek(bool On) {
+  Put(RDA5807M_Reg::SEEK, On); //  NOTE: Reset to false by SF=1 or STC=1
+  if (On)
+     Trigger();
+  else
+     Set();
+  Started(On);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SeekDirection(bool Up) {
+  Put(RDA5807M_Reg::SEEKUP, Up);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::ClockFrequency(int Choice) {
+  Put(RDA5807M_Reg::CLK_MODE, (Choice >= 0) && (Choice <= 7)? Choice : 0);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SoftReset(bool On) {
+  Put(RDA5807M_Reg::SOFT_RESET, On);
+  Trigger();
+  Wr[0] &= ~RDA5807M_Reg::SOFT_RESET.Mask(); // do not trigger twice.
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::NewDemod(bool On) {
+  Put(RDA5807M_Reg::NEW_METHOD, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RDS_enable(bool On) {
+  Put(RDA5807M_Reg::RDS_EN, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::PowerUp(bool On) {
+  Put(RDA5807M_Reg::ENABLE, On);
+  Set(true);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::ChannelNumber(uint16_t Channel) {
+  Put(RDA5807M_Reg::CHAN, Channel & 0x3FF);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Started(bool On) {
+  tuning = On;
+  // the chip clears STC and SF on start, don't report the previous ones.
+  if (On) {
+     status.Rd[0] &= ~0x6000;
+     startedAt = bus.Millis();
+     }
+}
+
+template<class Transport>
+uint32_t RDA5807M_Driver<Transport>::BandStart(void) const {
+  switch(Field(RDA5807M_Reg::BAND)) {
+     case 0 : return 87000;
+     case 1 :
+     case 2 : return 76000;
+     default: return Field(RDA5807M_Reg::MODE_65MHz) ? 65000 : 50000;
+     }
+}
+
+template<class Transport>
+uint32_t RDA5807M_Driver<Transport>::BandEnd(void) const {
+  switch(Field(RDA5807M_Reg::BAND)) {
+     case 0 : return 108000;
+     case 1 : return 91000;
+     case 2 : return 108000;
+     default: return Field(RDA5807M_Reg::MODE_65MHz) ? 76000 : 65000;
+     }
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::Spacing(void) const {
+  static const uint8_t kHz[] = { 100, 200, 50, 25 };
+  return kHz[Field(RDA5807M_Reg::SPACE)];
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::Channels(void) const {
+  uint32_t n = (BandEnd() - BandStart()) / Spacing() + 1;
+  return (n > 1024) ? 1024 : n;
+}
+
+template<class Transport>
+uint32_t RDA5807M_Driver<Transport>::Frequency(uint16_t Channel) const {
+  return BandStart() + (uint32_t) Channel * Spacing();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::TestMode(bool On) {
+  Put(RDA5807M_Reg::DIRECT_MODE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Tune(bool On) {
+  Put(RDA5807M_Reg::TUNE, On);
+  if (On)
+     Trigger();
+  else
+     Set();
+  Started(On);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Band(int Choice) {
+  Put(RDA5807M_Reg::MODE_65MHz, Choice != 4);
+  Put(RDA5807M_Reg::BAND, (Choice == 4) ? 3 : Choice & 3);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::ChannelSpacing(int Choice) {
+  Put(RDA5807M_Reg::SPACE, Choice & 3);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SeekTuneInterrupt(bool On) {
+  Put(RDA5807M_Reg::STCIEN, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RBDS_enable(bool On) {
+  Put(RDA5807M_Reg::RBDS, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RDS_FIFO_mode(bool On) {
+  Put(RDA5807M_Reg::RDS_FIFO_EN, On);
+  Set();
+  rdsEmptyAt = bus.Millis();
+  rdsPhase   = 0;
+  rdsBalance = 0;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Deemphasis(bool Europe) {
+  Put(RDA5807M_Reg::DE, Europe);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Clear_RDS_FIFO(bool On) {
+  Put(RDA5807M_Reg::RDS_FIFO_CLR, On);
+  Set();
+  if (On) {
+     rdsEmptyAt = bus.Millis();
+     rdsPhase   = 0;
+     rdsBalance = 0;
+     }
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SoftMute(bool On) {
+  Put(RDA5807M_Reg::SOFTMUTE_EN, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::AFC(bool On) {
+  Put(RDA5807M_Reg::AFCD, not On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S(bool On) {
+  Put(RDA5807M_Reg::I2S_ENABLE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SetGPIO(int GPIO, int Choice) {
+  if ((Choice < 0) or (Choice > 3))
+     return;
+  if ((GPIO < 1) or (GPIO > 3))
+     return;
+  if ((GPIO == 2) and (Field(RDA5807M_Reg::STCIEN) or Field(RDA5807M_Reg::RDSIEN)))
+     gpio2 = Choice; // applied, once the interrupts are off.
+  else if (GPIO == 1) Put(RDA5807M_Reg::GPIO1, Choice);
+  else if (GPIO == 2) Put(RDA5807M_Reg::GPIO2, Choice);
+  else                Put(RDA5807M_Reg::GPIO3, Choice);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::InterruptMode(bool Wait) {
+  Put(RDA5807M_Reg::INT_MODE, Wait);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::AsyncInterrupt(bool On) {
+  InterruptPin(On or Field(RDA5807M_Reg::RDSIEN));
+  Put(RDA5807M_Reg::STCIEN, On);
+  Set();
+  useIrq = On;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::InterruptPin(bool On) {
+  // GPIO2 is the interrupt output while STCIEN or RDSIEN is set, the mode
+  // given by SetGPIO() is kept aside meanwhile.
+  bool active = Field(RDA5807M_Reg::STCIEN) or Field(RDA5807M_Reg::RDSIEN);
+  if (On and not active) {
+     gpio2 = Field(RDA5807M_Reg::GPIO2);
+     Put(RDA5807M_Reg::GPIO2, 1);
+     }
+  else if (not On and active)
+     Put(RDA5807M_Reg::GPIO2, gpio2);
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::TuneAsync(uint16_t Channel, TuneCallback Done, void* Context) {
+  if (Busy())
+     return false;
+  asyncDone    = Done;
+  asyncContext = Context;
+  irq          = false;
+  Put(RDA5807M_Reg::CHAN, Channel & 0x3FF);
+  Put(RDA5807M_Reg::SEEK, false);
+  Put(RDA5807M_Reg::TUNE, true);
+  Trigger();
+  Started(true);
+  return true;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::SeekAsync(bool Up, TuneCallback Done, void* Context) {
+  if (Busy())
+     return false;
+  asyncDone    = Done;
+  asyncContext = Context;
+  irq          = false;
+  Put(RDA5807M_Reg::SEEKUP, Up);
+  Put(RDA5807M_Reg::TUNE, false);
+  Put(RDA5807M_Reg::SEEK, true);
+  Trigger();
+  Started(true);
+  return true;
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::ChannelWord(uint16_t Channel) const {
+  return (Wr[1] & ~RDA5807M_Reg::CHAN.Mask()) | RDA5807M_Reg::CHAN.Encode(Channel & 0x3FF) |
+         RDA5807M_Reg::TUNE.Mask();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::ZapAsync(uint16_t Word, TuneCallback Done, void* Context) {
+  if (Busy())
+     return false;
+  asyncDone    = Done;
+  asyncContext = Context;
+  irq          = false;
+  // any other staged change stays dirty.
+  Wr[1]  = Word | RDA5807M_Reg::TUNE.Mask();
+  dirty &= ~(1 << 1);
+  Set(0x03, Wr[1]);
+  Started(true);
+  return true;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Service(void) {
+  if (not Busy())
+     return false;
+
+  if (not irq) {
+     unsigned long now = bus.Millis();
+     if (useIrq) {
+        if ((now - readAt[TuneStatus]) < AsyncFallbackTime)
+           return false;
+        }
+     else if (Field(RDA5807M_Reg::SEEK)) {
+        if ((now - readAt[TuneStatus]) < AsyncPollTime)
+           return false;
+        }
+     // a tune: not before it can be complete, then once per ms.
+     else if (((now - startedAt) < AsyncTuneTime) or (now == readAt[TuneStatus]))
+        return false;
+     }
+  irq = false;
+
+  // with INT_MODE set, GPIO2 stays low until 0x0C was read.
+  uint8_t words = Field(RDA5807M_Reg::INT_MODE) ? 3 : RDA5807M_Words[SignalStatus];
+  return Read(words) and Complete();
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Complete(void) {
+  if (not Busy() or not status.TuneComplete())
+     return false;
+
+  TuneCallback done = asyncDone;
+  asyncDone = 0;
+  done(asyncContext, status);
+  return true;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RDS_Interrupt(bool On) {
+  InterruptPin(On or Field(RDA5807M_Reg::STCIEN));
+  Put(RDA5807M_Reg::RDSIEN, On);
+  Set();
+}
+
+template<class Transport>
+template<class Queue>
+uint8_t RDA5807M_Driver<Transport>::Capture(Queue& Q) {
+  unsigned long a = MaxAge(RDSStatus);
+  if (not irq and ((bus.Millis() - readAt[RDSStatus]) < (a ? a : DefaultMaxAge)))
+     return 0;
+  irq = false;
+  return Drain(Q);
+}
+
+template<class Transport>
+template<class Queue>
+uint8_t RDA5807M_Driver<Transport>::Drain(Queue& Q) {
+  bool fifo = Field(RDA5807M_Reg::RDS_FIFO_EN);
+  uint8_t groups = 0, pushed = 0;
+
+  while(Read(RDA5807M_Words[RDSStatus])) {
+     Complete();
+     if (not status.RDS_ready()) {
+        if (fifo)
+           Account(groups);
+        break;
+        }
+     groups++;
+     if (Q.Push(status.Group()))
+        pushed++;
+     if (not fifo or (groups >= RDSDrainMax))
+        break;
+     }
+  return pushed;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Account(uint8_t Groups) {
+  // while RDS is synchronized, one group arrives per 87.6ms (701/8 ms).
+  // Compare with the groups drained since the fifo was found empty last
+  // time; the phase is carried, a balance of one group is tolerated.
+  unsigned long elapsed = status.Time - rdsEmptyAt;
+  rdsEmptyAt = status.Time;
+  if (not status.RDS_sync()) {
+     rdsPhase   = 0;
+     rdsBalance = 0;
+     return;
+     }
+
+  uint32_t units = elapsed * 8 + rdsPhase;
+  rdsPhase = units % 701;
+  int32_t balance = rdsBalance + (int32_t) (units / 701) - Groups;
+  if (balance > 1) {
+     rdsLost += balance - 1;
+     balance = 1;
+     }
+  rdsBalance = (balance < -1) ? -1 : balance;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RSSISeekMode(bool On) {
+  Put(RDA5807M_Reg::SEEK_MODE, On ? 2 : 0);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SeekThreshold(int Value) {
+  Put(RDA5807M_Reg::SEEKTH, Value & 0xF);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::LNA_InputPort(int Value) {
+  Put(RDA5807M_Reg::LNA_PORT_SEL, Value & 0x3);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::LNA_Current(int Value) {
+  Put(RDA5807M_Reg::LNA_ICSEL_BIT, Value & 0x3);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Volume(int Value) {
+  Put(RDA5807M_Reg::VOLUME, Value & 0xF);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RegisterMode(bool WriteBehind) {
+  Put(RDA5807M_Reg::OPEN_MODE, WriteBehind ? 3 : 0);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Slave(bool On) {
+  Put(RDA5807M_Reg::SLAVE_MASTER, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_WS_vs_LR(bool left_is_zero) {
+  Put(RDA5807M_Reg::WS_LR, left_is_zero);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Invert_SCLK(bool On) {
+  Put(RDA5807M_Reg::SCLK_I_EDGE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Signed(bool On) {
+  Put(RDA5807M_Reg::DATA_SIGNED, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Invert_WS(bool On) {
+  Put(RDA5807M_Reg::WS_I_EDGE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_WS_Step(int Choice) {
+  Put(RDA5807M_Reg::I2S_SW_CNT, Choice & 0xF);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Invert_WS_Out(bool On) {
+  Put(RDA5807M_Reg::SW_O_EDGE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_Invert_SCLK_Out(bool On) {
+  Put(RDA5807M_Reg::SCLK_O_EDGE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_DelayLeft(bool On) {
+  Put(RDA5807M_Reg::L_DELY, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::I2S_DelayRight(bool On) {
+  Put(RDA5807M_Reg::R_DELY, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::SoftblendThreshold(int Threshold) {
+  Put(RDA5807M_Reg::TH_SOFTBLEND, Threshold & 0x1F);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::RSSISeekThreshold(int Threshold) {
+  Put(RDA5807M_Reg::SEEK_TH_OLD, Threshold & 0x3F);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Softblend(bool On) {
+  Put(RDA5807M_Reg::SOFTBLEND_EN, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::FrequencyChanged(bool On) {
+  Put(RDA5807M_Reg::FREQ_MODE, On);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::FrequencyDirect(uint16_t Freq) {
+  Put(RDA5807M_Reg::FREQ_DIRECT, Freq);
+  Set();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Debug(void) {
+  uint16_t Reg;
+  bus.Print("\n");
+
+  for(int i=0x2; i<=0xB; i++) {
+     char buf[8];
+     Reg = Get(i);
+     sprintf(buf, "%X: %04X", i, Reg);
+     bus.Print(buf);
+     bus.Print("\n");
+     }
+}
+
+
+/*******************************************************************************
+ * General members following.
+ ******************************************************************************/
+template<class Transport>
+void RDA5807M_Driver<Transport>::Set(uint8_t Register, uint16_t Value) {
+  uint8_t buf[3];
+  buf[0] = Register;
+  buf[1] = Value >> 8;
+  buf[2] = Value & 0xFF;
+  unsigned long start = Tracer::Micros(bus);
+  bus.Write(Address + 1, buf, sizeof(buf));
+  Tracer::Add(bus, Register, Value, 0, start, Tracer::Micros(bus) - start);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Set(const uint16_t* Values, uint8_t Count) {
+  uint8_t buf[2 * 7] = {};
+  for(uint8_t i=0; i<Count; i++) {
+     buf[2*i]   = Values[i] >> 8;
+     buf[2*i+1] = Values[i] & 0xFF;
+     }
+  unsigned long start = Tracer::Micros(bus);
+  bus.Write(Address, buf, 2 * Count); // sequential write, starts at 0x02
+  if (Tracer::On) {
+     unsigned long duration = Tracer::Micros(bus) - start;
+     for(uint8_t i=0; i<Count; i++)
+        Tracer::Add(bus, 0x02 + i, Values[i], Tracer::Burst, start, duration);
+     }
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::BeginBatch(void) {
+  batch++;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::EndBatch(void) {
+  if (batch and (--batch == 0))
+     Commit();
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Commit(void) {
+  if (not staged)
+     return;
+  Flush(forced);
+  staged = forced = false;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Set(bool force) {
+  if (batch) {
+     staged = true;
+     forced = forced or force;
+     return;
+     }
+  Flush(force);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Trigger(void) {
+  // actions are never deferred: a status read later in the batch would see
+  // the previous STC and complete them before they started.
+  Flush(forced);
+  staged = forced = false;
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Put(RDA5807M_Field F, uint16_t Value) {
+  uint8_t i = F.Register - 0x02;
+  uint16_t w = (Wr[i] & ~F.Mask()) | F.Encode(Value);
+  // setting an action bit (SEEK, TUNE, ..) starts it again.
+  if ((w != Wr[i]) or (F.Encode(Value) & RDA5807M_Reg::Triggers[i])) {
+     Wr[i] = w;
+     dirty |= 1 << i;
+     }
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::Field(RDA5807M_Field F) const {
+  return F.Decode(Wr[F.Register - 0x02]);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Flush(bool force) {
+  if (force)
+     dirty = 0x7F;
+  if (not dirty)
+     return;
+
+#if RDA5807M_DEBUG
+  char buf[8];
+  for(uint8_t i=0; i<7; i++) {
+     sprintf(buf, i < 6 ? "%04X, " : "%04X\n", Wr[i]);
+     bus.Print(buf);
+     }
+#endif
+
+  uint8_t count = 0, last = 0;
+  for(uint8_t i=0; i<7; i++) {
+     if (dirty & (1 << i)) {
+        count++;
+        last = i;
+        }
+     }
+
+  // each byte is 9 clocks incl. ACK, plus start and stop per transaction.
+  lastCommit.Random = count * ((1 + 1 + 2) * 9 + 2);
+  lastCommit.Burst  = (1 + 2 * (last + 1)) * 9 + 2;
+  lastCommit.UsedBurst = lastCommit.Burst <= lastCommit.Random;
+  for(uint8_t i=0; i<last; i++)
+     if (not (dirty & (1 << i)) and (Wr[i] & RDA5807M_Reg::Triggers[i]))
+        lastCommit.UsedBurst = false;
+
+  if (lastCommit.UsedBurst)
+     Set(Wr, last + 1);
+  else {
+     for(uint8_t i=0; i<=last; i++)
+        if (dirty & (1 << i))
+           Set(0x2 + i, Wr[i]);
+     }
+  // the chip clears RDS_FIFO_CLR by itself, the next write of 0x04 must not
+  // clear the fifo again.
+  Wr[2] &= ~RDA5807M_Reg::RDS_FIFO_CLR.Mask();
+  dirty = 0;
+}
+
+template<class Transport>
+uint16_t RDA5807M_Driver<Transport>::Get(uint8_t Register) {
+  uint8_t buf[2];
+  unsigned long start = Tracer::Micros(bus);
+  if (not bus.WriteRead(Address + 1, &Register, 1, buf, sizeof(buf)))
+     return 0;
+  uint16_t result = (buf[0] << 8) | buf[1];
+  Tracer::Add(bus, Register, result, Tracer::Read, start, Tracer::Micros(bus) - start);
+  return result;
+}
+
+template<class Transport>
+unsigned long RDA5807M_Driver<Transport>::MaxAge(StatusGroup Group) const {
+  if ((Group == TuneStatus) and not tuning)
+     return 0;
+  return maxAge[Group];
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Subscribe(StatusGroup Group, unsigned long MaxAge) {
+  maxAge[Group] = MaxAge;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Poll(void) {
+  // unsigned differences, safe on millis() wraparound.
+  unsigned long now = bus.Millis();
+  uint8_t words = 0;
+  for(int g=TuneStatus; g<=RDSStatus; g++) {
+     unsigned long a = MaxAge((StatusGroup) g);
+     if (a and ((now - readAt[g]) >= a))
+        words = RDA5807M_Words[g];
+     }
+  return words and Read(words);
+}
+
+template<class Transport>
+void RDA5807M_Driver<Transport>::Get(StatusGroup Group) {
+  unsigned long a = MaxAge(Group);
+  if ((bus.Millis() - readAt[Group]) < (a ? a : DefaultMaxAge))
+     return;
+  Read(RDA5807M_Words[Group]);
+}
+
+template<class Transport>
+typename RDA5807M_Driver<Transport>::Status RDA5807M_Driver<Transport>::ReadStatus(void) {
+  Read();
+  return LastStatus();
+}
+
+template<class Transport>
+typename RDA5807M_Driver<Transport>::Status RDA5807M_Driver<Transport>::ReadStatus(StatusGroup Group) {
+  Read(RDA5807M_Words[Group]);
+  return LastStatus();
+}
+
+template<class Transport>
+typename RDA5807M_Driver<Transport>::Status RDA5807M_Driver<Transport>::LastStatus(void) const {
+  return status;
+}
+
+template<class Transport>
+bool RDA5807M_Driver<Transport>::Read(uint8_t Words) {
+  unsigned long now = bus.Millis();
+  for(int g=TuneStatus; g<=RDSStatus; g++)
+     if (RDA5807M_Words[g] <= Words)
+        readAt[g] = now;
+
+  uint8_t buf[6 * sizeof(uint16_t)];
+  unsigned long start = Tracer::Micros(bus);
+  if (not bus.Read(Address, buf, 2 * Words))
+     return false;
+#if RDA5807M_DEBUG
+  bus.Print("read ");
+#endif
+  for(int i=0; i<Words; i++)
+     status.Rd[i] = (buf[2*i] << 8) | buf[2*i+1]; // 0x0A..0x0F
+  if (Tracer::On) {
+     unsigned long duration = Tracer::Micros(bus) - start;
+     for(int i=0; i<Words; i++)
+        Tracer::Add(bus, 0x0A + i, status.Rd[i], Tracer::Read | Tracer::Burst,
+                    start, duration);
+     }
+  status.Time = now;
+  status.Sequence++;
+  if (tuning and status.TuneComplete()) {
+     // the chip clears TUNE and SEEK by itself, a seek doesn't update CHAN.
+     tuning = false;
+     Wr[0] &= ~RDA5807M_Reg::SEEK.Mask();
+     Wr[1] &= ~RDA5807M_Reg::TUNE.Mask();
+     Wr[1]  = RDA5807M_Reg::With(Wr[1], RDA5807M_Reg::CHAN, status.ChannelNumber());
+     }
+  if (recorder)
+     recorder(recordContext, status, Words, Wr[1]);
+  return true;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Asynchronous tune: time from TuneAsync() to the callback and the bus
+// transactions, with the STC interrupt and polled, against a blocking
+// Tune(true) waiting on TuneComplete().
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static bool done;
+static uint16_t channel;
+static void Done(void*, const RDA5807M_Status& S) {
+  done    = true;
+  channel = S.ChannelNumber();
+}
+
+static int failed = 0;
+
+static void Async(bool Interrupt) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  if (Interrupt)
+     chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.AsyncInterrupt(Interrupt);
+  const int Tunes = 20;
+  uint64_t us = 0;
+  uint32_t transactions = 0;
+  for(int i=0; i<Tunes; i++) {
+     uint16_t target = 10 + 10 * i;
+     uint64_t start = chip.Micros();
+     uint32_t t = chip.Transactions;
+     done = false;
+     radio.TuneAsync(target, Done);
+     while(not done)
+        radio.Service();
+     us += chip.Micros() - start;
+     transactions += chip.Transactions - t;
+     if (channel != target)
+        failed++;
+     }
+  printf("TuneAsync(), %s: %5.1f ms, %.1f transactions per tune\n",
+         Interrupt ? "irq   " : "polled", us / 1000.0 / Tunes, (double) transactions / Tunes);
+}
+
+static void Blocking(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  uint64_t start = chip.Micros();
+  TuneTo(radio, 100);
+  printf("Tune(true) + TuneComplete(): %.1f ms\n", (chip.Micros() - start) / 1000.0);
+}
+
+int main(void) {
+  Async(true);
+  Async(false);
+  Blocking();
+  return failed ? 1 : 0;
+}
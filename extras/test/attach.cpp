@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Warm attach: a second driver attached to a running chip writes nothing
+// on attach and only real changes afterwards, keeps the interrupt setup,
+// and the bus time of Attach() at 100 and 400kHz.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Traced<RDA5807M_SimBus, 64> TracedBus;
+typedef RDA5807M_Driver<TracedBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+static void Check(bool Ok, const char* What) {
+  printf("%-44s %s\n", What, Ok ? "ok" : "FAILED");
+  if (not Ok)
+     failed++;
+}
+
+// register writes in the trace since Clear().
+static uint16_t Writes(Radio& R, uint8_t Register = 0) {
+  const TracedBus::TraceBuffer& t = R.Bus().Trace();
+  uint16_t n = 0;
+  for(uint16_t i=0; i<t.Size(); i++)
+     if (not (t[i].Flags & TracedBus::TraceBuffer::Read) and
+         (not Register or (t[i].Register == Register)))
+        n++;
+  return n;
+}
+
+// last value written to Register, 0xFFFF = none.
+static uint16_t Written(Radio& R, uint8_t Register) {
+  const TracedBus::TraceBuffer& t = R.Bus().Trace();
+  uint16_t v = 0xFFFF;
+  for(uint16_t i=0; i<t.Size(); i++)
+     if (not (t[i].Flags & TracedBus::TraceBuffer::Read) and (t[i].Register == Register))
+        v = t[i].Value;
+  return v;
+}
+
+static bool done;
+static void Done(void*, const RDA5807M_Status&) { done = true; }
+
+static void Warm(bool Interrupts) {
+  RDA5807M_Sim chip;
+  Radio before(chip);
+  before.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  before.SetGPIO(2, 2);
+  before.Volume(5);
+  TuneTo(before, 100);
+  if (Interrupts) {
+     before.AsyncInterrupt(true);
+     before.RDS_Interrupt(true);
+     }
+
+  // the µC reboots, the chip keeps running.
+  Radio radio(chip);
+  if (Interrupts)
+     chip.OnInterrupt(Irq, &radio);
+  uint32_t bytes = chip.BusBytes;
+  uint64_t start = chip.Micros();
+  bool attached = radio.Attach();
+  bytes = chip.BusBytes - bytes;
+  uint64_t us = chip.Micros() - start;
+  Check(attached and not Writes(radio) and (radio.Channel() == 100),
+        Interrupts ? "attach, interrupts on: nothing written" : "attach: nothing written");
+
+  radio.Bus().Trace().Clear();
+  radio.Volume(5);
+  radio.SetGPIO(1, 0);
+  bool none = not Writes(radio);
+  radio.Volume(7);
+  Check(none and (Writes(radio) == 1) and (Writes(radio, 0x05) == 1),
+        "only real changes written");
+
+  if (Interrupts) {
+     // STC interrupt still used: one status read after the pulse, no polling.
+     uint32_t reads = chip.Transactions;
+     done = false;
+     radio.TuneAsync(120, Done);
+     while(not done)
+        radio.Service();
+     reads = chip.Transactions - reads - 1;
+     Check(reads == 1, "STC interrupt kept");
+
+     radio.Bus().Trace().Clear();
+     radio.RDS_Interrupt(false);
+     bool kept = Written(radio, 0x04) == 0xFFFF or
+                 RDA5807M_Reg::GPIO2.Decode(Written(radio, 0x04)) == 1;
+     radio.AsyncInterrupt(false);
+     Check(kept and RDA5807M_Reg::GPIO2.Decode(Written(radio, 0x04)) == 0,
+           "GPIO2 high impedance once interrupts are off");
+     }
+  else {
+     printf("Attach(): %u bytes, %.2f ms at 100kHz", bytes, us / 1000.0);
+     RDA5807M_Sim fast;
+     fast.BusClock = 400000;
+     Radio r1(fast);
+     r1.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+     Radio r2(fast);
+     start = fast.Micros();
+     r2.Attach();
+     printf(", %.2f ms at 400kHz\n", (fast.Micros() - start) / 1000.0);
+     }
+}
+
+int main(void) {
+  Warm(false);
+  Warm(true);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Batched configuration: a tune inside a batch, followed by a status read
+// in the same batch, has to reach the chip and complete on the new channel.
+// A copied Batch guard would end the batch twice, so it can't be copied.
+
+#include <stdio.h>
+#include <type_traits>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static_assert(not std::is_copy_constructible<Radio::Batch>::value and
+              not std::is_copy_assignable<Radio::Batch>::value, "Batch is copyable");
+
+static int failed = 0;
+
+static void Expect(const char* What, RDA5807M_Sim& Chip, Radio& R, uint16_t Channel) {
+  R.ReadStatus();
+  bool ok = (R.LastStatus().ChannelNumber() == Channel) and
+            ((Chip.Register(0x03) >> 6) == Channel);
+  printf("%-28s channel %3u, reg 0x03 = 0x%04X: %s\n", What,
+         R.LastStatus().ChannelNumber(), Chip.Register(0x03), ok ? "ok" : "FAILED");
+  if (not ok)
+     failed++;
+}
+
+static bool done;
+static void Done(void*, const RDA5807M_Status&) { done = true; }
+
+int main(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 6);
+  Expect("Tune(true)", chip, radio, 6);
+
+  {
+  Radio::Batch batch(radio);
+  radio.ChannelNumber(121);
+  radio.Tune(true);
+  radio.ReadStatus();
+  }
+  while(not radio.TuneComplete());
+  Expect("Tune(true) in a batch", chip, radio, 121);
+
+  {
+  Radio::Batch batch(radio);
+  radio.Volume(3);
+  radio.TuneAsync(66, Done);
+  radio.ReadStatus();
+  radio.Service();
+  if (done) {
+     printf("TuneAsync() in a batch completed with a stale status\n");
+     failed++;
+     }
+  }
+  while(not done)
+     radio.Service();
+  Expect("TuneAsync() in a batch", chip, radio, 66);
+  return failed ? 1 : 0;
+}
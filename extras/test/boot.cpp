@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Boot path: no bus access from the constructor, Begin() writes the power
+// up image once and polls until FM_READY and STC.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+// counts write and read transactions.
+class Counting : public RDA5807M_SimBus {
+public:
+  static unsigned Writes, Reads;
+  Counting(RDA5807M_Sim& Sim) : RDA5807M_SimBus(Sim) {}
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+    Writes++;
+    return RDA5807M_SimBus::Write(Address, Data, Count);
+  }
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    Reads++;
+    return RDA5807M_SimBus::Read(Address, Data, Count);
+  }
+};
+unsigned Counting::Writes = 0, Counting::Reads = 0;
+
+int main(void) {
+  RDA5807M_Sim chip;
+  RDA5807M_Driver<Counting> radio(chip);
+  bool quiet = chip.Transactions == 0;
+  bool ok = radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  printf("constructor: %s bus access\n", quiet ? "no" : "UNEXPECTED");
+  printf("Begin(): %s, ready after %lu ms (power up %u ms, tune %u ms), "
+         "%u write(s), %u status polls\n", ok ? "ok" : "FAILED", radio.BootTime(),
+         (unsigned) (chip.PowerUpTime / 1000), (unsigned) (chip.TuneTime / 1000),
+         Counting::Writes, Counting::Reads);
+  return (quiet and ok and (Counting::Writes == 1)) ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDS capture: a main loop calling Capture() every ms over 10s, on the
+// RDS ready interrupt and polled at the default rate, counting the groups
+// captured against the groups the sim sent and the bus transactions.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Ring.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+static void Captured(bool Interrupt) {
+  static const RDA5807M_Sim::Station band[] = {
+    { 87600, 60, true, 0xD318, 1, "DLF", 0 } };
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  Radio radio(chip);
+  if (Interrupt)
+     chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 6);
+  radio.RDS_Interrupt(Interrupt);
+  RDA5807M_Ring<RDA5807M_Group, 16> queue;
+  RDA5807M_Group g;
+  radio.Capture(queue);
+  while(queue.Pop(g));
+
+  uint32_t first = chip.Groups(), transactions = chip.Transactions;
+  uint32_t captured = 0;
+  uint16_t lastB = 0;
+  bool ordered = true;
+  for(int ms=0; ms<10000; ms++) {
+     chip.Advance(1000);
+     radio.Capture(queue);
+     while(queue.Pop(g)) {
+        // PS segments are sent 0, 1, 2, 3, 0, ..
+        if (captured and Interrupt and ((g.Block[1] & 3) != ((lastB + 1) & 3)))
+           ordered = false;
+        lastB = g.Block[1];
+        captured++;
+        }
+     }
+  uint32_t sent = chip.Groups() - first;
+  transactions = chip.Transactions - transactions;
+  printf("%s: %3lu of %3lu groups captured in %4lu transactions\n",
+         Interrupt ? "interrupt" : "polled   ", (unsigned long) captured,
+         (unsigned long) sent, (unsigned long) transactions);
+  if (Interrupt and ((captured != sent) or (transactions != sent) or not ordered))
+     failed++;
+  // the default rate of 500ms, one group in about 6.
+  if (not Interrupt and ((captured < sent / 7) or (captured > sent / 5)))
+     failed++;
+}
+
+int main(void) {
+  Captured(true);
+  Captured(false);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Batch decoding of capture records: every column against the
+// RDA5807M_Status getters, for the plain and the parallel decoder, and
+// the throughput, and a count which is no multiple of the block sizes.
+// The Makefile builds this once per code path:
+//   columns         SSE2 (x86-64 default)
+//   columns_scalar  -DRDA5807M_SIMD=0
+//   columns_avx2    -mavx2
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "RDA5807M_Capture.h"
+#include "RDA5807M_Columns.h"
+
+static const uint32_t Count = 4000000;
+
+struct Table {
+  std::vector<uint32_t> time;
+  std::vector<uint16_t> channel, block[4];
+  std::vector<uint8_t>  rssi, flags, blera, blerb;
+  RDA5807M_Columns c;
+  Table(uint32_t n) : time(n), channel(n), rssi(n), flags(n), blera(n), blerb(n) {
+    for(int i=0; i<4; i++)
+       block[i].resize(n);
+    c.Time = time.data(); c.Channel = channel.data(); c.Rssi = rssi.data();
+    c.Flags = flags.data(); c.BlerA = blera.data(); c.BlerB = blerb.data();
+    for(int i=0; i<4; i++)
+       c.Block[i] = block[i].data();
+  }
+};
+
+static uint32_t Mismatches(const uint8_t* Records, const Table& T, uint32_t N = Count) {
+  uint32_t bad = 0;
+  for(uint32_t i=0; i<N; i++) {
+     RDA5807M_Capture::Record r;
+     RDA5807M_Capture::Decode(Records + i * RDA5807M_Capture::RecordSize, r);
+     RDA5807M_Status s;
+     memcpy(s.Rd, r.Rd, sizeof(s.Rd));
+     uint8_t flags = (s.StereoIndicator() ? RDA5807M_Columns::Stereo       : 0) |
+                     (s.RDS_BlockE()      ? RDA5807M_Columns::BlockE       : 0) |
+                     (s.RDS_sync()        ? RDA5807M_Columns::RDSSync      : 0) |
+                     (s.SeekFail()        ? RDA5807M_Columns::SeekFail     : 0) |
+                     (s.TuneComplete()    ? RDA5807M_Columns::TuneComplete : 0) |
+                     (s.RDS_ready()       ? RDA5807M_Columns::RDSReady     : 0) |
+                     (s.IsStation()       ? RDA5807M_Columns::FMTrue       : 0) |
+                     (s.FM_ready()        ? RDA5807M_Columns::FMReady      : 0);
+     if ((T.time[i] != r.Time) or (T.channel[i] != s.ChannelNumber()) or
+         (T.rssi[i] != s.SignalStrength()) or (T.flags[i] != flags) or
+         (T.blera[i] != s.RDS_BlockErrors_A()) or (T.blerb[i] != s.RDS_BlockErrors_B()) or
+         (T.block[0][i] != s.RDS_BlockA()) or (T.block[1][i] != s.RDS_BlockB()) or
+         (T.block[2][i] != s.RDS_BlockC()) or (T.block[3][i] != s.RDS_BlockD()))
+        bad++;
+     }
+  return bad;
+}
+
+template<class F>
+static double Seconds(F Decode) {
+  double best = 1e9;
+  for(int run=0; run<5; run++) {
+     auto t0 = std::chrono::steady_clock::now();
+     Decode();
+     double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+     if (s < best)
+        best = s;
+     }
+  return best;
+}
+
+int main(void) {
+#if defined(__AVX2__)
+  if (not __builtin_cpu_supports("avx2")) {
+     printf("no AVX2 on this CPU, skipped\n");
+     return 0;
+     }
+  const char* path = "AVX2";
+#elif defined(__SSE2__)
+  const char* path = "SSE2";
+#else
+  const char* path = "scalar";
+#endif
+  if (not RDA5807M_SIMD)
+     path = "scalar";
+
+  std::vector<uint8_t> records(Count * RDA5807M_Capture::RecordSize);
+  srand(1);
+  for(uint32_t i=0; i<Count; i++) {
+     RDA5807M_Capture::Record r;
+     r.Time = i * 10 + rand() % 10;
+     for(int w=0; w<6; w++)
+        r.Rd[w] = rand();
+     r.Tune  = rand();
+     r.Words = 1 + rand() % 6;
+     RDA5807M_Capture::Encode(r, records.data() + i * RDA5807M_Capture::RecordSize);
+     }
+
+  int failed = 0;
+  Table t(Count);
+  double s = Seconds([&] { RDA5807M_Decode(records.data(), Count, RDA5807M_Capture::RecordSize, t.c); });
+  uint32_t bad = Mismatches(records.data(), t);
+  printf("%-6s %u records: %6.1f M records/s, %u mismatches\n", path, Count, Count / s / 1e6, bad);
+  failed += bad > 0;
+
+  // a count, which is no multiple of the block sizes.
+  Table tail(Count);
+  RDA5807M_Decode(records.data(), 1021, RDA5807M_Capture::RecordSize, tail.c);
+  bad = Mismatches(records.data(), tail, 1021);
+  printf("%-6s 1021 records: %u mismatches\n", path, bad);
+  failed += bad > 0;
+
+  for(unsigned threads=2; threads<=4; threads*=2) {
+     Table p(Count);
+     s = Seconds([&] { RDA5807M_DecodeParallel(records.data(), Count, RDA5807M_Capture::RecordSize, p.c, threads); });
+     bad = Mismatches(records.data(), p);
+     printf("%-6s %u threads:      %6.1f M records/s, %u mismatches\n", path, threads, Count / s / 1e6, bad);
+     failed += bad > 0;
+     }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Register commits: cost of random and burst writes in SCL cycles as
+// reported by LastCommit(), the cheaper one has to be used, and the bus
+// time the simulator saw.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static int failed = 0;
+
+static void Report(const char* What, Radio& R, RDA5807M_Sim& Chip, uint64_t Since) {
+  Radio::CommitCost c = R.LastCommit();
+  bool cheaper = c.UsedBurst ? (c.Burst <= c.Random) : (c.Random < c.Burst);
+  printf("%-10s random %3u, burst %3u -> %-6s %4u us on the bus%s\n", What, c.Random, c.Burst,
+         c.UsedBurst ? "burst" : "random", (unsigned) (Chip.Micros() - Since),
+         cheaper ? "" : ", NOT THE CHEAPER ONE");
+  if (not cheaper)
+     failed++;
+}
+
+int main(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  uint64_t t = chip.Micros();
+  radio.PowerUp(true);
+  Report("PowerUp()", radio, chip, t);
+  t = chip.Micros();
+  radio.Volume(3);
+  Report("Volume()", radio, chip, t);
+  t = chip.Micros();
+  radio.Mono(true);
+  Report("Mono()", radio, chip, t);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDS export: golden hex lines and binary records, the block error rule of
+// RDA5807M_RDS, and 60s of simulated reception exported through serial
+// links of 2400 and 1200 baud with back-pressure.
+
+#include <stdio.h>
+#include <string.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Ring.h"
+#include "RDA5807M_Export.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static int failed = 0;
+
+static void Check(bool Ok, const char* What) {
+  printf("%-40s %s\n", What, Ok ? "ok" : "FAILED");
+  if (not Ok)
+     failed++;
+}
+
+// collects everything.
+struct Buffer {
+  uint8_t data[64];
+  uint16_t size;
+  Buffer(void) : size(0) {}
+  uint16_t Write(const uint8_t* Data, uint16_t Count) {
+    memcpy(data + size, Data, Count);
+    size += Count;
+    return Count;
+  }
+};
+
+static bool Hex(uint8_t BlerA, uint8_t BlerB, const char* Golden) {
+  RDA5807M_Group g = { { 0xD3C2, 0x2001, 0x4E44, 0x5220 }, BlerA, BlerB, 6, 0 };
+  RDA5807M_Export<Buffer> exporter;
+  exporter.Put(g);
+  const Buffer& b = exporter.Output();
+  return (b.size == strlen(Golden)) and not memcmp(b.data, Golden, b.size);
+}
+
+static void Golden(void) {
+  Check(Hex(0, 0, "D3C2 2001 4E44 5220\n"), "hex, error free");
+  Check(Hex(1, 2, "D3C2 2001 4E44 5220\n"), "hex, corrected errors");
+  Check(Hex(3, 0, "---- 2001 4E44 5220\n"), "hex, block A unusable");
+  Check(Hex(0, 3, "D3C2 ---- ---- ----\n"), "hex, block B..D unusable");
+
+  RDA5807M_Group g = { { 0xD3C2, 0x2001, 0x4E44, 0x5220 }, 1, 2, 0x0123, 0x12345678 };
+  RDA5807M_Export<Buffer> exporter(Buffer(), RDA5807M_Export<Buffer>::Binary);
+  exporter.Put(g);
+  const uint8_t golden[16] = { 0x78, 0x56, 0x34, 0x12, 0xC2, 0xD3, 0x01, 0x20,
+                               0x44, 0x4E, 0x20, 0x52, 0x06, 0x23, 0x01, 0x00 };
+  const Buffer& b = exporter.Output();
+  Check((b.size == 16) and not memcmp(b.data, golden, 16), "binary record");
+}
+
+// a serial link of Baud (8N1) on the simulator's clock.
+static RDA5807M_Sim* simulated;
+struct Serial {
+  uint32_t Baud;
+  uint64_t written;
+  Serial(uint32_t B = 2400) : Baud(B), written(0) {}
+  uint16_t Write(const uint8_t*, uint16_t Count) {
+    uint64_t sent = simulated->Micros() * (Baud / 10) / 1000000;
+    uint16_t n = (sent - written < Count) ? sent - written : Count;
+    written += n;
+    return n;
+  }
+};
+
+static const RDA5807M_Sim::Station band[] = {
+  { 87600, 60, true, 0xD318, 1, "DLF", "Deutschlandfunk" } };
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static void Link(uint32_t Baud, RDA5807M_Export<Serial>::Format F, bool Lossless) {
+  RDA5807M_Sim chip;
+  simulated = &chip;
+  chip.Stations(band, 1);
+  Radio radio(chip);
+  chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.RDS_Interrupt(true);
+
+  RDA5807M_Ring<RDA5807M_Group, 16> queue;
+  RDA5807M_Export<Serial> exporter(Serial(Baud), F);
+  exporter.Output().written = chip.Micros() * (Baud / 10) / 1000000;
+  uint32_t groups = chip.Groups();
+  unsigned long start = radio.Bus().Millis();
+  while((radio.Bus().Millis() - start) < 60000) {
+     radio.Capture(queue);
+     RDA5807M_Group g;
+     while(exporter.Flush() and queue.Pop(g))
+        exporter.Put(g);
+     }
+  groups = chip.Groups() - groups;
+  printf("%4u baud, %s: %u groups sent, %u exported, %u dropped\n", Baud,
+         (F == RDA5807M_Export<Serial>::Hex) ? "hex   " : "binary", groups, exporter.Records,
+         queue.Dropped());
+  // the last ones may still be queued.
+  bool ok = Lossless ? not queue.Dropped() and (exporter.Records + 16 >= groups) : queue.Dropped() > 0;
+  if (not ok)
+     failed++;
+}
+
+int main(void) {
+  Golden();
+  Link(2400, RDA5807M_Export<Serial>::Hex, true);
+  Link(2400, RDA5807M_Export<Serial>::Binary, true);
+  Link(1200, RDA5807M_Export<Serial>::Hex, false);
+  Link(1200, RDA5807M_Export<Serial>::Binary, false);
+  return failed ? 1 : 0;
+}
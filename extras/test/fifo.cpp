@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDS fifo mode: groups queued by the chip survive unrelated writes of
+// register 0x04 after Clear_RDS_FIFO(). Then a main loop draining every
+// 400ms and 800ms over 20s, with and without fifo: groups received and
+// RDS_Lost() against the groups the sim dropped by fifo overflow.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Ring.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static uint8_t Drained(bool SoftMute) {
+  static const RDA5807M_Sim::Station band[] = {
+    { 87600, 60, true, 0xD318, 1, "DLF", 0 } };
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 6);
+  radio.RDS_FIFO_mode(true);
+  radio.Clear_RDS_FIFO(true);
+  chip.Advance(600000);
+  if (SoftMute)
+     radio.SoftMute(true);
+  RDA5807M_Ring<RDA5807M_Group, 16> queue;
+  return radio.Drain(queue);
+}
+
+static int failed = 0;
+
+static void Visits(unsigned long Period, bool Fifo) {
+  static const RDA5807M_Sim::Station band[] = {
+    { 87600, 60, true, 0xD318, 1, "DLF", 0 } };
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 6);
+  radio.RDS_FIFO_mode(Fifo);
+  radio.Clear_RDS_FIFO(true);
+  uint32_t first = chip.Groups();
+  uint32_t received = 0;
+  RDA5807M_Ring<RDA5807M_Group, 64> queue;
+  for(int i=0; i < (int) (20000 / Period); i++) {
+     chip.Advance(Period * 1000);
+     received += radio.Drain(queue);
+     RDA5807M_Group g;
+     while(queue.Pop(g));
+     }
+  uint32_t sent = chip.Groups() - first;
+  printf("visits every %3lu ms, fifo %s: %3lu of %3lu groups, sim dropped %2lu, RDS_Lost() %2lu\n",
+         Period, Fifo ? "on " : "off", (unsigned long) received, (unsigned long) sent,
+         (unsigned long) chip.FifoOverflows, (unsigned long) radio.RDS_Lost());
+  if (not Fifo)
+     return;
+  // the estimate may be off by the one group of tolerated balance.
+  uint32_t lost = radio.RDS_Lost(), dropped = chip.FifoOverflows;
+  if ((received + dropped > sent) or (received + dropped + 1 < sent))
+     failed++;
+  if ((lost > dropped) or (lost + 2 < dropped) or (dropped and not lost))
+     failed++;
+}
+
+int main(void) {
+  uint8_t plain = Drained(false);
+  uint8_t muted = Drained(true);
+  printf("groups after 600ms: %u, with SoftMute() in between: %u\n", plain, muted);
+  if (not plain or (muted != plain))
+     failed++;
+  Visits(400, true);
+  Visits(400, false);
+  Visits(800, true);
+  return failed ? 1 : 0;
+}
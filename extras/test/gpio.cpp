@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// GPIO2 as interrupt output: the mode set by SetGPIO() is back, once the
+// interrupts are off again.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static int failed = 0;
+
+static void Expect(const char* What, RDA5807M_Sim& Chip, uint8_t Mode) {
+  uint8_t gpio2 = (Chip.Register(0x04) >> 2) & 3;
+  printf("%-28s GPIO2 mode %u %s\n", What, gpio2, (gpio2 == Mode) ? "ok" : "FAILED");
+  if (gpio2 != Mode)
+     failed++;
+}
+
+int main(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.SetGPIO(2, 2);
+  radio.Volume(3); // SetGPIO() is written with the next change.
+  Expect("SetGPIO(2, high)", chip, 2);
+  radio.AsyncInterrupt(true);
+  Expect("AsyncInterrupt(true)", chip, 1);
+  radio.SetGPIO(2, 3);
+  radio.Volume(4);
+  Expect("SetGPIO(2, low) meanwhile", chip, 1);
+  radio.AsyncInterrupt(false);
+  Expect("AsyncInterrupt(false)", chip, 3);
+
+  radio.RDS_Interrupt(true);
+  Expect("RDS_Interrupt(true)", chip, 1);
+  radio.AsyncInterrupt(true);
+  radio.RDS_Interrupt(false);
+  Expect("RDS off, STC still on", chip, 1);
+  radio.AsyncInterrupt(false);
+  Expect("both off", chip, 3);
+  radio.RDS_Interrupt(true);
+  radio.RDS_Interrupt(false);
+  Expect("RDS_Interrupt(false)", chip, 3);
+  return failed ? 1 : 0;
+}
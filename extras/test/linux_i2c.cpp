@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDA5807M_LinuxI2C without hardware: ioctl() is replaced by a shim, which
+// passes I2C_RDWR transfers to a RDA5807M_Sim and keeps the messages of the
+// last call. Checks that register and status reads are exactly one I2C_RDWR
+// call each, with the expected messages.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_LinuxI2C.h"
+#include "shared.h"
+
+static const int FakeFd = 1000;
+static RDA5807M_Sim chip;
+
+static unsigned calls;
+static unsigned nmsgs;
+static struct i2c_msg msgs[4];
+
+extern "C" int ioctl(int Fd, unsigned long Request, ...) {
+  va_list ap;
+  va_start(ap, Request);
+  struct i2c_rdwr_ioctl_data* data = va_arg(ap, struct i2c_rdwr_ioctl_data*);
+  va_end(ap);
+  if ((Fd != FakeFd) or (Request != I2C_RDWR) or (data->nmsgs > 4)) {
+     errno = EINVAL;
+     return -1;
+     }
+  calls++;
+  nmsgs = data->nmsgs;
+  for(unsigned i=0; i<nmsgs; i++) {
+     struct i2c_msg& m = data->msgs[i];
+     msgs[i] = m;
+     bool ok = (m.flags & I2C_M_RD) ? chip.Read(m.addr, m.buf, m.len) :
+                                      chip.Write(m.addr, m.buf, m.len);
+     if (not ok) {
+        errno = EIO;
+        return -1;
+        }
+     }
+  return nmsgs;
+}
+
+static int failed = 0;
+
+struct Msg { uint16_t Addr; uint16_t Flags; uint16_t Len; };
+
+static void Expect(const char* What, unsigned Calls, const Msg* M, unsigned N) {
+  bool ok = (Calls == 1) and (nmsgs == N);
+  for(unsigned i=0; ok and (i<N); i++)
+     ok = (msgs[i].addr == M[i].Addr) and (msgs[i].flags == M[i].Flags) and
+          (msgs[i].len == M[i].Len);
+  printf("%-24s %u I2C_RDWR call(s), %u msg(s):", What, Calls, nmsgs);
+  for(unsigned i=0; i<nmsgs; i++)
+     printf(" [0x%02X %s %u]", msgs[i].addr, (msgs[i].flags & I2C_M_RD) ? "rd" : "wr", msgs[i].len);
+  printf(" %s\n", ok ? "ok" : "FAILED");
+  if (not ok)
+     failed++;
+}
+
+int main(void) {
+  RDA5807M_LinuxI2C bus(FakeFd);
+  RDA5807M_Driver<RDA5807M_LinuxI2C> radio(bus);
+  if (not radio.Begin(RDA5807M_PowerUpImage(DefaultConfig))) {
+     printf("Begin() failed\n");
+     return 1;
+     }
+
+  calls = 0;
+  unsigned id = radio.ChipId();
+  const Msg get[] = { { 0x11, 0, 1 }, { 0x11, I2C_M_RD, 2 } };
+  Expect("ChipId()", calls, get, 2);
+  if (id != 0x5804)
+     failed++;
+
+  calls = 0;
+  radio.ReadStatus();
+  const Msg status[] = { { 0x10, I2C_M_RD, 12 } };
+  Expect("ReadStatus()", calls, status, 1);
+
+  calls = 0;
+  radio.ReadStatus(RDA5807M_Driver<RDA5807M_LinuxI2C>::TuneStatus);
+  const Msg tune[] = { { 0x10, I2C_M_RD, 2 } };
+  Expect("ReadStatus(TuneStatus)", calls, tune, 1);
+
+  calls = 0;
+  radio.Volume(3);
+  const Msg write[] = { { 0x11, 0, 3 } };
+  Expect("Volume(3)", calls, write, 1);
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Occupancy monitor: time until a station going off air and back on is
+// reported, sweep only and with hot revisits. Checks that a restart begins
+// with an empty map, that the score follows the formula of
+// RDA5807M_Monitor on every visit, that a long gap clears all slots and that the channel
+// tuned before is restored.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Monitor.h"
+#include "shared.h"
+
+static RDA5807M_Sim::Station band[] = {
+  {  87600, 45, true,  0, 0, 0, 0 }, {  93600, 60, true,  0, 0, 0, 0 },
+  {  99100, 50, true,  0, 0, 0, 0 }, { 103000, 35, true,  0, 0, 0, 0 },
+  };
+static const uint8_t Stations = sizeof(band) / sizeof(band[0]);
+static const uint16_t Changing = 66; // 93.6MHz
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+typedef RDA5807M_Monitor<RDA5807M_SimBus> Monitor;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+// ms until Changing is reported as Occupied, -1 = not within 60s.
+static long Until(Radio& R, Monitor& M, bool Occupied) {
+  unsigned long start = R.Bus().Millis();
+  RDA5807M_ChannelDiff d;
+  while((R.Bus().Millis() - start) < 60000) {
+     M.Step();
+     while(M.Diffs().Pop(d))
+        if ((d.Channel == Changing) and (d.Occupied == Occupied))
+           return d.Time - start;
+     }
+  return -1;
+}
+
+static void Run(Radio& R, Monitor& M, unsigned long Ms) {
+  unsigned long start = R.Bus().Millis();
+  RDA5807M_ChannelDiff d;
+  while((R.Bus().Millis() - start) < Ms) {
+     M.Step();
+     while(M.Diffs().Pop(d));
+     }
+}
+
+static void Detect(uint8_t HotShare) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, Stations);
+  Radio radio(chip);
+  chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.AsyncInterrupt(true);
+  Monitor monitor(radio);
+  monitor.HotShare = HotShare;
+  monitor.Start();
+  long on = Until(radio, monitor, true);
+  band[1].Rssi = 5;
+  band[1].Frequency = 93650;
+  long off = Until(radio, monitor, false);
+  band[1].Rssi = 60;
+  band[1].Frequency = 93600;
+  long back = Until(radio, monitor, true);
+  monitor.Stop();
+  while(monitor.Step());
+  printf("HotShare %u: found after %5ld ms, off air after %5ld ms, back after %5ld ms, %u of %u visits hot\n",
+         HotShare, on, off, back, monitor.HotVisits, monitor.Visits);
+  if ((on < 0) or (off < 0) or (back < 0))
+     failed++;
+}
+
+static void Restart(void) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, Stations);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  // no status read after the tune.
+  radio.ChannelNumber(121);
+  radio.Tune(true);
+  chip.Advance(100000);
+
+  Monitor monitor(radio);
+  monitor.Start();
+  Until(radio, monitor, true);
+  // a gap longer than all slots.
+  chip.Advance(3600000000UL);
+  Run(radio, monitor, 1000);
+  bool cleared = true;
+  for(uint8_t s=1; s<8; s++)
+     for(uint16_t c=0; c<monitor.Channels(); c++)
+        cleared = cleared and not monitor.Sample(c, s);
+  monitor.Stop();
+  while(monitor.Step());
+  bool restored = radio.LastStatus().ChannelNumber() == 121;
+
+  // all stations gone: nothing may be left of the first run.
+  chip.Stations(band, 0);
+  monitor.Start();
+  bool empty = monitor.Diffs().Empty() and (monitor.Visits == 0);
+  for(uint16_t c=0; c<monitor.Channels(); c++)
+     empty = empty and not monitor.Occupied(c) and not monitor.Score(c) and
+             not monitor.Sample(c, 1);
+  monitor.Stop();
+  while(monitor.Step());
+
+  printf("slots cleared after a gap: %s, restart empty: %s, restored: %s\n",
+         cleared ? "ok" : "FAILED", empty ? "ok" : "FAILED", restored ? "ok" : "FAILED");
+  if (not (cleared and empty and restored))
+     failed++;
+}
+
+// Two channels, 87.0MHz switched on and off, 87.1MHz always empty: every
+// score has to be the one of the formula, with at least one step.
+static void Scores(void) {
+  RDA5807M_Sim::Station one[] = { { 87000, 50, true, 0, 0, 0, 0 } };
+  RDA5807M_Sim chip;
+  chip.Stations(one, 1);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  RDA5807M_Monitor<RDA5807M_SimBus, 2> monitor(radio);
+  monitor.HotShare = 0;
+  monitor.Start();
+
+  int32_t score[2] = { 0, 0 };
+  unsigned long seen[2] = { 0, 0 };
+  bool visited[2] = { false, false };
+  int wrong = 0, partial = 0;
+  for(uint32_t visit=0; visit<400; visit++) {
+     if (visit == 100) {
+        one[0].Frequency = 87050;
+        one[0].Rssi = 5;
+        }
+     while(monitor.Visits == visit)
+        monitor.Step();
+     const RDA5807M_Status& S = radio.LastStatus();
+     uint16_t c = S.ChannelNumber();
+     unsigned long t = S.Time - seen[c];
+     int32_t diff = (S.IsStation() ? 255 : 0) - score[c];
+     if (not visited[c] or (t >= monitor.DecayTime))
+        score[c] += diff;
+     else if (t and diff) {
+        int32_t step = diff * (int32_t) t / (int32_t) monitor.DecayTime;
+        score[c] += step ? step : ((diff > 0) ? 1 : -1);
+        partial++;
+        }
+     seen[c] = S.Time;
+     visited[c] = true;
+     if (monitor.Score(c) != score[c])
+        wrong++;
+     }
+  monitor.Stop();
+  while(monitor.Step());
+  bool ok = not wrong and partial and not monitor.Occupied(0) and
+            not monitor.Occupied(1) and (monitor.Score(1) == 0);
+  printf("scores: %d partial decays, %d differ from the formula, empty channel %s\n",
+         partial, wrong, (monitor.Occupied(1) or monitor.Score(1)) ? "FAILED" : "free");
+  if (not ok)
+     failed++;
+}
+
+int main(void) {
+  Detect(0);
+  Detect(1);
+  Detect(2);
+  Scores();
+  Restart();
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Open Data Applications: 3A binding, dispatch and RadioText Plus tags on
+// a RadioText, and the dispatch time per group.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "RDA5807M_RDS.h"
+#include "RDA5807M_ODA.h"
+
+static int failed = 0;
+
+static void Check(bool Ok, const char* What) {
+  printf("%-40s %s\n", What, Ok ? "ok" : "FAILED");
+  if (not Ok)
+     failed++;
+}
+
+static RDA5807M_Group Group(uint8_t Type, uint16_t B, uint16_t C, uint16_t D) {
+  RDA5807M_Group g = { { 0xD318, (uint16_t) ((Type << 11) | (10 << 5) | (B & 0x1F)), C, D },
+                       0, 0, 0, 0 };
+  return g;
+}
+
+static const char* RT = "Now playing: Queen - Bohemian Rhapsody\r";
+static const uint8_t RTPlusGroup = 0x16; // 11A
+
+// 3A, announcing AID in group type Type.
+static RDA5807M_Group Announce(uint8_t Type, uint16_t AID) {
+  return Group(0x06, Type, 0x0000, AID);
+}
+
+// RT+ group: two tags, item toggle and running bits.
+static RDA5807M_Group Tags(uint8_t Type1, uint8_t Start1, uint8_t Length1,
+                           uint8_t Type2, uint8_t Start2, uint8_t Length2,
+                           bool Toggle, bool Running) {
+  uint16_t B = (Toggle << 4) | (Running << 3) | (Type1 >> 3);
+  uint16_t C = ((Type1 & 7) << 13) | (Start1 << 7) | ((Length1 - 1) << 1) | (Type2 >> 5);
+  uint16_t D = ((Type2 & 0x1F) << 11) | (Start2 << 5) | (Length2 - 1);
+  return Group(RTPlusGroup, B, C, D);
+}
+
+static void RadioText(RDA5807M_RDS& Rds) {
+  uint8_t len = strlen(RT);
+  for(uint8_t segment=0; 4 * segment < len; segment++) {
+     char c[4];
+     for(int i=0; i<4; i++)
+        c[i] = (4 * segment + i < len) ? RT[4 * segment + i] : ' ';
+     Rds.Decode(Group(0x04, segment, (c[0] << 8) | c[1], (c[2] << 8) | c[3]));
+     }
+}
+
+int main(void) {
+  RDA5807M_RDS rds;
+  RDA5807M_RTPlus rtplus(rds);
+  RDA5807M_ODA oda;
+  Check(oda.Register(RDA5807M_RTPlus::AID, RDA5807M_RTPlus::Handler, &rtplus),
+        "RT+ registered");
+  RadioText(rds);
+
+  RDA5807M_Group tags = Tags(RDA5807M_RTPlus::Artist, 13, 5, RDA5807M_RTPlus::Title, 21, 17,
+                             true, true);
+  Check(not oda.Decode(tags), "not dispatched before 3A");
+  Check(oda.Decode(Announce(RTPlusGroup, RDA5807M_RTPlus::AID)) and
+        (oda.AID(RTPlusGroup) == RDA5807M_RTPlus::AID), "3A binds 11A to RT+");
+  Check(oda.Decode(tags), "11A dispatched");
+
+  char artist[65], title[65], truncated[6];
+  bool a = rtplus.Tag(RDA5807M_RTPlus::Artist, artist, sizeof(artist));
+  bool t = rtplus.Tag(RDA5807M_RTPlus::Title, title, sizeof(title));
+  Check(a and t and not strcmp(artist, "Queen") and not strcmp(title, "Bohemian Rhapsody") and
+        rtplus.Toggle() and rtplus.Running(), "artist and title extracted");
+  Check(rtplus.Tag(RDA5807M_RTPlus::Title, truncated, sizeof(truncated)) and
+        not strcmp(truncated, "Bohem"), "tag truncated to the buffer");
+  Check(not rtplus.Tag(RDA5807M_RTPlus::Album, title, sizeof(title)), "untagged content type");
+
+  // next item: the tags of the previous one are gone.
+  oda.Decode(Tags(RDA5807M_RTPlus::Title, 21, 17, 0, 0, 1, false, true));
+  Check(not rtplus.Tag(RDA5807M_RTPlus::Artist, artist, sizeof(artist)) and
+        rtplus.Tag(RDA5807M_RTPlus::Title, title, sizeof(title)), "item toggle clears the tags");
+
+  // 3A with application group 0x1F: temporary data fault, no binding.
+  oda.Decode(Announce(0x1F, RDA5807M_RTPlus::AID));
+  Check((oda.AID(0x1F) == 0) and not oda.Decode(Group(0x1F, 0, 0, 0)),
+        "3A with group 0x1F ignored");
+
+  oda.Reset();
+  Check((oda.AID(RTPlusGroup) == 0) and not oda.Decode(tags), "Reset() forgets the binding");
+
+  // dispatch time: a stream of 0A, 2A and 11A groups.
+  oda.Decode(Announce(RTPlusGroup, RDA5807M_RTPlus::AID));
+  std::vector<RDA5807M_Group> stream;
+  for(int i=0; i<1000; i++) {
+     stream.push_back(Group(0x00, i & 3, 0, 0x2020));
+     stream.push_back(Group(0x04, i & 15, 0x2020, 0x2020));
+     stream.push_back(tags);
+     }
+  const int Passes = 1000;
+  uint32_t handled = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for(int pass=0; pass<Passes; pass++)
+     for(size_t i=0; i<stream.size(); i++)
+        handled += oda.Decode(stream[i]);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  printf("dispatch: %.1f ns per group (%zu groups x %d)\n", ns / (stream.size() * Passes),
+         stream.size(), Passes);
+  if (handled != 1000u * Passes)
+     failed++;
+  return failed ? 1 : 0;
+}
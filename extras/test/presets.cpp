@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Preset zap: time from Zap() to audio and the bytes written, polled, with
+// the STC interrupt and muted, against a blocking tune. Presets of band 3
+// and 4 are refused in the other band.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Presets.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+static void Zap(const char* Name, bool Interrupt, bool Mute) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  if (Interrupt)
+     chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.AsyncInterrupt(Interrupt);
+  RDA5807M_Presets<RDA5807M_SimBus> presets(radio);
+  presets.Mute = Mute;
+  const int Zaps = 16;
+  for(int n=0; n<Zaps; n++)
+     presets.Store(n, 10 + 12 * n);
+  uint64_t us = 0;
+  unsigned long ms = 0;
+  for(int n=0; n<Zaps; n++) {
+     uint64_t start = chip.Micros();
+     uint32_t bytes = chip.BusBytes;
+     if (not presets.Zap(n))
+        failed++;
+     bytes = chip.BusBytes - bytes;
+     while(presets.Step());
+     us += chip.Micros() - start;
+     ms += presets.Latency();
+     if ((radio.LastStatus().ChannelNumber() != 10 + 12 * n) or (bytes != (Mute ? 7 : 4)))
+        failed++;
+     }
+  printf("Zap(), %-7s: %5.1f ms, Latency() %5.1f ms\n", Name, us / 1000.0 / Zaps, (double) ms / Zaps);
+}
+
+static void Blocking(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  uint64_t start = chip.Micros();
+  TuneTo(radio, 100);
+  printf("Tune(true) + TuneComplete(): %.1f ms\n", (chip.Micros() - start) / 1000.0);
+}
+
+static void Bands(void) {
+  RDA5807M_Sim chip;
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  RDA5807M_Presets<RDA5807M_SimBus> presets(radio);
+  radio.Band(4);
+  presets.Store(0, 20); // 52.0MHz
+  radio.Band(3);
+  presets.Store(1, 20); // 67.0MHz
+  bool refused = not presets.Zap(0);
+  bool zapped = presets.Zap(1);
+  while(presets.Step());
+  bool at67 = radio.LastStatus().ChannelNumber() == 20 and radio.BandStart() == 65000;
+  radio.Band(4);
+  refused = refused and not presets.Zap(1);
+  printf("band 3/4 presets: %s\n", (refused and zapped and at67) ? "ok" : "FAILED");
+  if (not (refused and zapped and at67))
+     failed++;
+}
+
+int main(void) {
+  Zap("polled", false, false);
+  Zap("irq", true, false);
+  Zap("muted", true, true);
+  Blocking();
+  Bands();
+  return failed ? 1 : 0;
+}
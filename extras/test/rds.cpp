@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDS decoder: time from tune to a reliable PS and RadioText, error free
+// and with 2% block errors, and the decoding time per group. The sim is
+// deterministic, the times fail beyond 1s for PS and 10s for RT.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Ring.h"
+#include "RDA5807M_RDS.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static const char* PS = "DLF";
+static const char* RT = "Deutschlandfunk - Nachrichten und Informationen";
+static const RDA5807M_Sim::Station band[] = { { 87600, 60, true, 0xD318, 1, PS, RT } };
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+// ms from STC until PS and RT are valid, groups are appended to Groups.
+static void Receive(uint16_t ErrorRate, uint32_t Offset, unsigned long& PsAt,
+                    unsigned long& RtAt, std::vector<RDA5807M_Group>& Groups) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  for(int i=0; i<4; i++)
+     chip.BlockErrorRate[i] = ErrorRate;
+  Radio radio(chip);
+  chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  chip.Advance(Offset);
+  TuneTo(radio, 6);
+  radio.RDS_Interrupt(true);
+  unsigned long start = radio.Bus().Millis();
+
+  RDA5807M_RDS rds;
+  RDA5807M_Ring<RDA5807M_Group, 16> queue;
+  PsAt = RtAt = 0;
+  while(((radio.Bus().Millis() - start) < 60000) and not (PsAt and RtAt)) {
+     radio.Capture(queue);
+     RDA5807M_Group g;
+     while(queue.Pop(g)) {
+        Groups.push_back(g);
+        rds.Decode(g);
+        if (not PsAt and (rds.Valid() & RDA5807M_RDS::ValidPS))
+           PsAt = g.Time - start;
+        if (not RtAt and (rds.Valid() & RDA5807M_RDS::ValidRT))
+           RtAt = g.Time - start;
+        }
+     }
+  if (strncmp(rds.PS(), PS, strlen(PS)) or strcmp(rds.RT(), RT) or (rds.PI() != 0xD318))
+     failed++;
+}
+
+int main(void) {
+  std::vector<RDA5807M_Group> groups;
+  for(uint16_t rate=0; rate<=20; rate+=20) {
+     const int Runs = 20;
+     unsigned long ps = 0, rt = 0;
+     for(int run=0; run<Runs; run++) {
+        unsigned long p, r;
+        Receive(rate, run * 37000, p, r, groups);
+        ps += p;
+        rt += r;
+        if (not p or not r)
+           failed++;
+        }
+     printf("block error rate %2u.%u%%: PS reliable after %4lu ms, RT after %4lu ms (mean of %d)\n",
+            rate / 10, rate % 10, ps / Runs, rt / Runs, Runs);
+     if ((ps / Runs > 1000) or (rt / Runs > 10000))
+        failed++;
+     }
+
+  RDA5807M_RDS rds;
+  const int Passes = 200;
+  auto t0 = std::chrono::steady_clock::now();
+  for(int pass=0; pass<Passes; pass++)
+     for(size_t i=0; i<groups.size(); i++)
+        rds.Decode(groups[i]);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  printf("decoding: %.1f ns per group (%zu groups x %d)\n", ns / (groups.size() * Passes), groups.size(), Passes);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Record and replay: a simulated session is recorded into memory and
+// replayed to an unmodified driver. Checks the replay gives the recorded
+// status reads, that throttled getters don't stall the replay clock, and
+// that unknown capture versions are rejected.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Capture.h"
+#include "shared.h"
+
+static std::vector<uint8_t> capture;
+static std::vector<RDA5807M_Status> replayed;
+
+static void Record(void*, const RDA5807M_Status& S, uint8_t Words, uint16_t Reg03) {
+  uint8_t buf[RDA5807M_Capture::RecordSize];
+  RDA5807M_Capture::Encode(RDA5807M_Capture::Make(S, Words, Reg03), buf);
+  capture.insert(capture.end(), buf, buf + sizeof(buf));
+}
+
+static void Replayed(void*, const RDA5807M_Status& S, uint8_t, uint16_t) {
+  replayed.push_back(S);
+}
+
+
+int main(void) {
+  int failed = 0;
+  static const RDA5807M_Sim::Station band[] = {
+    { 93600, 60, true, 0xD318, 1, "DLF", "Deutschlandfunk" } };
+
+  // record 10 minutes.
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  RDA5807M_Driver<RDA5807M_SimBus> radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.Tune(93600);
+  uint8_t header[RDA5807M_Capture::HeaderSize];
+  RDA5807M_Capture::Header(header);
+  capture.assign(header, header + sizeof(header));
+  std::vector<RDA5807M_Status> recorded;
+  radio.Record(Record);
+  unsigned long start = radio.Bus().Millis();
+  radio.Subscribe(RDA5807M_Driver<RDA5807M_SimBus>::RDSStatus, 87);
+  radio.Subscribe(RDA5807M_Driver<RDA5807M_SimBus>::SignalStatus, 1000);
+  while((radio.Bus().Millis() - start) < 600000) {
+     if (radio.Poll())
+        recorded.push_back(radio.LastStatus());
+     }
+  radio.Record(0);
+
+  // replay it, as fast as possible.
+  RDA5807M_Replay replay(capture.data(), capture.size());
+  RDA5807M_Driver<RDA5807M_Replay> player(replay);
+  player.Attach();
+  player.Record(Replayed);
+  player.Subscribe(RDA5807M_Driver<RDA5807M_Replay>::RDSStatus, 87);
+  player.Subscribe(RDA5807M_Driver<RDA5807M_Replay>::SignalStatus, 1000);
+  auto t0 = std::chrono::steady_clock::now();
+  while(not player.Bus().End())
+     player.Poll();
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  size_t same = 0;
+  for(size_t i=0; (i < replayed.size()) and (i + 1 < recorded.size()); i++)
+     if ((replayed[i].Time == recorded[i+1].Time) and not memcmp(replayed[i].Rd, recorded[i+1].Rd, sizeof(replayed[i].Rd)))
+        same++;
+  printf("replay of %u records (10 min) in %.1f ms, %zu of %zu reads identical\n",
+         replay.Records(), ms, same, recorded.size() - 1);
+  if (same != recorded.size() - 1)
+     failed++;
+
+  // throttled getters: the clock has to move on without reads.
+  RDA5807M_Replay idle(capture.data(), capture.size());
+  RDA5807M_Driver<RDA5807M_Replay> cached(idle);
+  if (not cached.Attach())
+     printf("Attach() failed\n");
+  for(int i=0; i<100000; i++)
+     cached.RDS_BlockB();
+  printf("100000 RDS_BlockB() calls: record %u of %u, replay time %lu ms\n",
+         cached.Bus().Position(), cached.Bus().Records(), cached.Bus().Millis());
+  if (cached.Bus().Position() < 2)
+     failed++;
+
+  // versions.
+  for(uint16_t v=0; v<=2; v++) {
+     std::vector<uint8_t> c(capture);
+     RDA5807M_Capture::Put16(c.data() + 8, v);
+     bool ok = RDA5807M_Capture::Check(c.data(), c.size()) != 0;
+     printf("version %u: %s\n", v, ok ? "accepted" : "rejected");
+     if (ok != (v == RDA5807M_Capture::Version))
+        failed++;
+     }
+  return failed ? 1 : 0;
+}
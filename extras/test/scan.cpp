@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Band scan: RDA5807M_Scanner polled and with the STC interrupt, against a
+// loop of blocking seeks, on 87..108MHz at 100kHz. Checks the stations
+// found and that the channel tuned before is restored. Then the same for
+// every band and channel spacing.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Scan.h"
+#include "shared.h"
+
+static const RDA5807M_Sim::Station band[] = {
+  {  87600, 45, true,  0, 0, 0, 0 }, {  89300, 30, false, 0, 0, 0, 0 },
+  {  93600, 60, true,  0, 0, 0, 0 }, {  96000, 40, true,  0, 0, 0, 0 },
+  {  99100, 50, true,  0, 0, 0, 0 }, { 103000, 35, true,  0, 0, 0, 0 },
+  { 107900, 28, false, 0, 0, 0, 0 },
+  };
+static const uint8_t Stations = sizeof(band) / sizeof(band[0]);
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+static int failed = 0;
+
+static void Scan(bool Interrupt) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, Stations);
+  Radio radio(chip);
+  if (Interrupt)
+     chip.OnInterrupt(Irq, &radio);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.AsyncInterrupt(Interrupt);
+  // no status read after the tune.
+  radio.ChannelNumber(121);
+  radio.Tune(true);
+  chip.Advance(100000);
+
+  RDA5807M_Station table[16];
+  RDA5807M_Scanner<RDA5807M_SimBus> scan(radio);
+  scan.Start(table, 16);
+  while(scan.Step());
+  uint16_t restored = radio.ReadStatus().ChannelNumber();
+  printf("scanner, %s: %4lu ms, %u stations, restored channel %u\n",
+         Interrupt ? "irq   " : "polled", scan.Duration(), scan.Found(), restored);
+  if ((scan.Found() != Stations) or (restored != 121))
+     failed++;
+  for(uint8_t i=0; i<scan.Found(); i++)
+     if (radio.Frequency(table[i].Channel) != band[i].Frequency)
+        failed++;
+}
+
+static void SeekLoop(void) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, Stations);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 0);
+  unsigned long start = radio.Bus().Millis();
+  uint8_t found = 0;
+  uint16_t last = 0;
+  for(;;) {
+     radio.Seek(true);
+     while(not radio.TuneComplete());
+     uint16_t ch = radio.ChannelNumber();
+     if (radio.SeekFail() or (ch <= last))
+        break;
+     found++;
+     last = ch;
+     }
+  printf("seek loop:        %4lu ms, %u stations\n", radio.Bus().Millis() - start, found);
+}
+
+// ms of a seek loop over the band, stations found.
+static unsigned long Seeks(Radio& R, uint8_t& Found) {
+  TuneTo(R, 0);
+  unsigned long start = R.Bus().Millis();
+  uint16_t last = 0;
+  Found = 0;
+  for(;;) {
+     R.Seek(true);
+     while(not R.TuneComplete());
+     uint16_t ch = R.ChannelNumber();
+     if (R.SeekFail() or (ch <= last))
+        break;
+     Found++;
+     last = ch;
+     }
+  return R.Bus().Millis() - start;
+}
+
+// three stations per band, on the grid of every spacing.
+static void Matrix(void) {
+  static const char* Bands[5] = { "87-108", "76-91 ", "76-108", "65-76 ", "50-65 " };
+  static const uint16_t Spacing[4] = { 100, 200, 50, 25 };
+  printf("band MHz spacing channels  polled     irq  seek loop\n");
+  for(uint8_t b=0; b<5; b++) {
+     for(uint8_t sp=0; sp<4; sp++) {
+        RDA5807M_Config config = DefaultConfig;
+        config.Band    = b;
+        config.Spacing = sp;
+        config.Channel = 0;
+        unsigned long ms[3];
+        uint8_t found[3];
+        uint16_t channels = 0;
+        for(int mode=0; mode<3; mode++) {
+           RDA5807M_Sim chip;
+           Radio radio(chip);
+           bool irq = mode == 1;
+           if (irq)
+              chip.OnInterrupt(Irq, &radio);
+           radio.Begin(RDA5807M_PowerUpImage(config));
+           radio.AsyncInterrupt(irq);
+           RDA5807M_Sim::Station s[3];
+           for(int i=0; i<3; i++) {
+              RDA5807M_Sim::Station st = { radio.BandStart() + 1200 + 3800 * i, (uint8_t) (40 + 5 * i),
+                                           true, 0, 0, 0, 0 };
+              s[i] = st;
+              }
+           chip.Stations(s, 3);
+           channels = radio.Channels();
+           if (mode == 2) {
+              ms[mode] = Seeks(radio, found[mode]);
+              continue;
+              }
+           RDA5807M_Station table[8];
+           RDA5807M_Scanner<RDA5807M_SimBus> scan(radio);
+           scan.Start(table, 8);
+           while(scan.Step());
+           ms[mode] = scan.Duration();
+           found[mode] = scan.Found();
+           for(uint8_t i=0; i<scan.Found(); i++)
+              if (radio.Frequency(table[i].Channel) != s[i].Frequency)
+                 failed++;
+           }
+        printf("%s   %3u kHz %8u %5lu ms %5lu ms %7lu ms\n", Bands[b], Spacing[sp], channels,
+               ms[0], ms[1], ms[2]);
+        if ((found[0] != 3) or (found[1] != 3) or (found[2] != 3))
+           failed++;
+        }
+     }
+}
+
+int main(void) {
+  Scan(false);
+  Scan(true);
+  SeekLoop();
+  Matrix();
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+#ifndef RDA5807M_TEST_SHARED_H
+#define RDA5807M_TEST_SHARED_H
+
+#include <stdint.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+
+// power up: band 0, 100kHz, RDS on, volume 8, 87.6MHz.
+static constexpr RDA5807M_Config DefaultConfig = { 0, 0, 0, true, 8, 2, 0, false, true, 6 };
+
+// blocking tune.
+template<class Radio>
+static void TuneTo(Radio& R, uint16_t Channel) {
+  R.ChannelNumber(Channel);
+  R.Tune(true);
+  while(not R.TuneComplete());
+}
+
+/*******************************************************************************
+ * Transport to a RDA5807M_Sim, with one clock for all simulated chips: like
+ * several chips on one bus, driven by one CPU. Every chip is brought forward
+ * to the common time before it's accessed.
+ ******************************************************************************/
+class SharedBus {
+private:
+  RDA5807M_Sim* sim;
+  void Sync(void) {
+    if (sim->Micros() < Now)
+       sim->Advance(Now - sim->Micros());
+  }
+  bool Done(bool Result) {
+    Now = sim->Micros();
+    return Result;
+  }
+public:
+  static uint64_t Now; // us
+
+  SharedBus(RDA5807M_Sim& Sim) : sim(&Sim) {}
+
+  bool Write(uint8_t Address, const uint8_t* Data, uint8_t Count) {
+    Sync();
+    return Done(sim->Write(Address, Data, Count));
+  }
+
+  bool Read(uint8_t Address, uint8_t* Data, uint8_t Count) {
+    Sync();
+    return Done(sim->Read(Address, Data, Count));
+  }
+
+  bool WriteRead(uint8_t Address, const uint8_t* Out, uint8_t OutCount,
+                 uint8_t* In, uint8_t InCount) {
+    Sync();
+    return Done(sim->Write(Address, Out, OutCount) and sim->Read(Address, In, InCount));
+  }
+
+  unsigned long Millis(void) {
+    Sync();
+    unsigned long ms = sim->Millis();
+    Done(true);
+    return ms;
+  }
+
+  unsigned long Micros(void) {
+    Sync();
+    return sim->Micros();
+  }
+
+  void Print(const char*) {}
+};
+
+uint64_t SharedBus::Now = 0;
+
+#endif
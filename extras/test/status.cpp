@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Status reads only as long as needed: 5 seeks with a 5ms TuneStatus
+// subscription, against reading the full 12 byte window at the same rate.
+// Fails below a reduction of 4x.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static const RDA5807M_Sim::Station band[] = {
+  {  87600, 45, true, 0, 0, 0, 0 }, {  93600, 60, true, 0, 0, 0, 0 },
+  {  99100, 50, true, 0, 0, 0, 0 }, { 103000, 35, true, 0, 0, 0, 0 },
+  { 107900, 40, true, 0, 0, 0, 0 },
+  };
+
+// bus bytes of status reads and duration in ms.
+static void Seeks(bool Full, uint32_t& Bytes, unsigned long& Ms) {
+  RDA5807M_Sim chip;
+  chip.Stations(band, 5);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 0);
+  radio.Subscribe(Radio::TuneStatus, 5);
+  Bytes = 0;
+  unsigned long start = radio.Bus().Millis();
+  for(int i=0; i<5; i++) {
+     radio.Seek(true);
+     unsigned long last = radio.Bus().Millis();
+     do {
+        uint32_t before = chip.BusBytes;
+        if (Full) {
+           while((radio.Bus().Millis() - last) < 5);
+           last = radio.Bus().Millis();
+           radio.ReadStatus();
+           }
+        else
+           radio.Poll();
+        Bytes += chip.BusBytes - before;
+        } while(not radio.LastStatus().TuneComplete());
+     }
+  Ms = radio.Bus().Millis() - start;
+}
+
+int main(void) {
+  uint32_t full, polled;
+  unsigned long fullMs, polledMs;
+  Seeks(true, full, fullMs);
+  Seeks(false, polled, polledMs);
+  printf("12 byte reads: %4u bus bytes in %lu ms, %4lu B/s\n", full, fullMs, full * 1000UL / fullMs);
+  printf("Poll():        %4u bus bytes in %lu ms, %4lu B/s\n", polled, polledMs, polled * 1000UL / polledMs);
+  uint32_t tenths = (full * 10 + polled / 2) / polled;
+  printf("reduction:     %u.%ux\n", tenths / 10, tenths % 10);
+  // the sim is deterministic, a smaller reduction is a regression.
+  return (polled * 4 < full) ? 0 : 1;
+}
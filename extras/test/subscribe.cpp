@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Status subscriptions: a main loop calling RDS_BlockB() every ms over 10s,
+// with an RDS subscription of 40ms and with the default age of 500ms.
+// Counts the status reads, which got a new group (RDSR set), against the
+// groups the sim sent.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "shared.h"
+
+typedef RDA5807M_Driver<RDA5807M_SimBus> Radio;
+
+static uint32_t seen = 0;
+
+static void Count(void*, const RDA5807M_Status& S, uint8_t Words, uint16_t) {
+  if ((Words == 6) and S.RDS_ready())
+     seen++;
+}
+
+static int failed = 0;
+
+static void Getters(unsigned long MaxAge) {
+  static const RDA5807M_Sim::Station band[] = {
+    { 87600, 60, true, 0xD318, 1, "DLF", 0 } };
+  RDA5807M_Sim chip;
+  chip.Stations(band, 1);
+  Radio radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  TuneTo(radio, 6);
+  if (MaxAge)
+     radio.Subscribe(Radio::RDSStatus, MaxAge);
+  radio.RDS_BlockB();
+  radio.Record(Count);
+  seen = 0;
+  uint32_t first = chip.Groups(), transactions = chip.Transactions;
+  for(int ms=0; ms<10000; ms++) {
+     chip.Advance(1000);
+     radio.RDS_BlockB();
+     }
+  uint32_t sent = chip.Groups() - first;
+  transactions = chip.Transactions - transactions;
+  printf("max. age %3lu ms: %3lu of %3lu groups seen in %3lu transactions\n",
+         MaxAge ? MaxAge : 500, (unsigned long) seen,
+         (unsigned long) sent, (unsigned long) transactions);
+  // the last group may arrive after the last read.
+  if (MaxAge and ((seen > sent) or (seen + 1 < sent)))
+     failed++;
+  if (not MaxAge and ((seen < sent / 7) or (seen > sent / 5)))
+     failed++;
+}
+
+int main(void) {
+  Getters(40);
+  Getters(0);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// RDS-TMC decoder: single group messages, multi group reassembly, skipped
+// repetitions and eviction from the full store, and the decoding time per
+// group of a synthetic stream with 3% block errors.
+
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "RDA5807M_TMC.h"
+
+static int failed = 0;
+
+static void Check(bool Ok, const char* What) {
+  printf("%-44s %s\n", What, Ok ? "ok" : "FAILED");
+  if (not Ok)
+     failed++;
+}
+
+// 8A group, PI 0xD318, TP, PTY 10; X = T, F, DP/CI of block B.
+static RDA5807M_Group Group(uint8_t X, uint16_t C, uint16_t D, unsigned long Time) {
+  RDA5807M_Group g = { { 0xD318, (uint16_t) (0x8000 | 0x0400 | (10 << 5) | (X & 0x1F)), C, D },
+                       0, 0, 0, Time };
+  return g;
+}
+
+// single group: F = 1, duration Duration.
+static RDA5807M_Group Single(uint16_t Location, uint16_t Event, bool Direction,
+                             uint8_t Extent, uint8_t Duration, unsigned long Time) {
+  return Group(0x08 | (Duration & 7), (Direction << 14) | ((Extent & 7) << 11) | (Event & 0x7FF),
+               Location, Time);
+}
+
+static void Singles(void) {
+  RDA5807M_TMC tmc;
+  bool first  = tmc.Decode(Single(12345, 101, true, 2, 3, 1000));
+  bool second = tmc.Decode(Single(12345, 101, true, 2, 3, 1100));
+  bool ok = not first and second and (tmc.Size() == 1) and (tmc[0].Location == 12345) and
+            (tmc[0].Event == 101) and tmc[0].Direction and (tmc[0].Extent == 2) and
+            (tmc[0].Duration == 3) and (tmc[0].Groups == 1);
+  Check(ok, "single group, stored on the repetition");
+
+  // the 3rd and 4th copy are repetitions, not updates.
+  bool third  = tmc.Decode(Single(12345, 101, true, 2, 3, 1200));
+  bool fourth = tmc.Decode(Single(12345, 101, true, 2, 3, 1300));
+  Check(not third and not fourth and (tmc.Duplicates == 2) and (tmc.Size() == 1) and
+        (tmc[0].Repeats == 0), "repetitions skipped");
+
+  // sent again later: an update of the stored message.
+  tmc.Decode(Single(12345, 101, true, 4, 3, 60000));
+  bool updated = tmc.Decode(Single(12345, 101, true, 4, 3, 60100));
+  Check(updated and (tmc.Size() == 1) and (tmc[0].Repeats == 1) and (tmc[0].Extent == 4) and
+        (tmc[0].Received == 1100) and (tmc[0].Updated == 60100), "later reception updates in place");
+
+  // block B with errors is ignored.
+  RDA5807M_Group bad = Single(999, 5, false, 0, 0, 70000);
+  bad.BLERB = 2;
+  tmc.Decode(bad);
+  tmc.Decode(bad);
+  Check(tmc.Size() == 1, "groups with block errors ignored");
+}
+
+static void Multi(void) {
+  RDA5807M_TMC tmc;
+  const uint8_t CI = 5;
+  // first group: F = 0, C bit 15 set.
+  bool r1 = tmc.Decode(Group(CI, 0x8000 | (1 << 14) | (1 << 11) | 401, 4711, 2000));
+  // second group, SG = 1, GSI = 2: two more to follow.
+  bool r2 = tmc.Decode(Group(CI, 0x4000 | (2 << 12) | 0xABC, 0xDEF0, 2100));
+  // a group of another continuity index in between is ignored.
+  bool rx = tmc.Decode(Group(CI ^ 1, (1 << 12) | 0x111, 0x2222, 2150));
+  bool r3 = tmc.Decode(Group(CI, (1 << 12) | 0x123, 0x4567, 2200));
+  bool r4 = tmc.Decode(Group(CI, (0 << 12) | 0x89A, 0xBCDE, 2300));
+  const uint8_t expect[11] = { 0xAB, 0xCD, 0xEF, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xE0 };
+  bool bits = true;
+  for(uint8_t i=0; i<11; i++)
+     bits = bits and (tmc[0].FreeFormat[i] == expect[i]);
+  Check(not r1 and not r2 and not rx and not r3 and r4 and (tmc.Size() == 1) and
+        (tmc[0].Groups == 4) and (tmc[0].Bits == 84) and (tmc[0].Location == 4711) and
+        (tmc[0].Event == 401) and tmc[0].Direction and (tmc[0].Extent == 1) and bits,
+        "multi group message reassembled");
+
+  // a missing group drops the message.
+  tmc.Decode(Group(CI, 0x8000 | 402, 4712, 3000));
+  tmc.Decode(Group(CI, 0x4000 | (2 << 12) | 0x001, 0x0002, 3100));
+  tmc.Decode(Group(CI, (0 << 12) | 0x003, 0x0004, 3300));
+  Check((tmc.Size() == 1) and (tmc.Incomplete == 1), "multi group message with a gap dropped");
+}
+
+static void Eviction(void) {
+  RDA5807M_TMC tmc;
+  const uint8_t N = RDA5807M_TMC::Capacity;
+  for(uint8_t i=0; i<=N; i++) {
+     tmc.Decode(Single(100 + i, 200, false, 0, 3, 1000 + 10 * i));
+     tmc.Decode(Single(100 + i, 200, false, 0, 3, 1005 + 10 * i));
+     }
+  bool first = false, last = false;
+  for(uint8_t i=0; i<tmc.Size(); i++) {
+     first = first or (tmc[i].Location == 100);
+     last  = last  or (tmc[i].Location == 100 + N);
+     }
+  Check((tmc.Size() == N) and (tmc.Evicted == 1) and not first and last,
+        "least recent message evicted from a full store");
+
+  // stored 5ms after this: all but the newest expired, no eviction.
+  unsigned long later = 990 + 10 * N + RDA5807M_TMC::Persistence(tmc[0]);
+  tmc.Decode(Single(999, 200, false, 0, 3, later));
+  tmc.Decode(Single(999, 200, false, 0, 3, later + 5));
+  Check((tmc.Evicted == 1) and (tmc.Expired == N - 1) and (tmc.Size() == 2),
+        "expired messages removed before evicting");
+}
+
+static uint32_t seed = 1;
+static uint32_t Rand(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static void Speed(void) {
+  // 4000 messages, 3 of 4 single group, sent twice; 3% of the groups with
+  // errors in block B; every 10th group tuning information.
+  std::vector<RDA5807M_Group> stream;
+  unsigned long t = 0;
+  for(int m=0; m<4000; m++) {
+     uint16_t location = Rand() & 0x7FFF, event = Rand() & 0x7FF;
+     if (m % 4) {
+        for(int n=0; n<2; n++)
+           stream.push_back(Single(location, event, Rand() & 1, Rand() & 7, Rand() & 7, t += 88));
+        }
+     else {
+        uint8_t ci = Rand() & 7;
+        stream.push_back(Group(ci, 0x8000 | event, location, t += 88));
+        stream.push_back(Group(ci, 0x4000 | (1 << 12) | (Rand() & 0xFFF), Rand(), t += 88));
+        stream.push_back(Group(ci, Rand() & 0xFFF, Rand(), t += 88));
+        }
+     if (not (m % 10))
+        stream.push_back(Group(0x10, Rand(), Rand(), t += 88));
+     }
+  for(size_t i=0; i<stream.size(); i++)
+     if ((Rand() % 100) < 3)
+        stream[i].BLERB = 3;
+
+  RDA5807M_TMC tmc;
+  const int Passes = 100;
+  uint32_t stored = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for(int pass=0; pass<Passes; pass++) {
+     tmc.Reset();
+     for(size_t i=0; i<stream.size(); i++)
+        stored += tmc.Decode(stream[i]);
+     }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  printf("decoding: %.1f ns per group (%zu groups x %d), %u messages stored per pass\n",
+         ns / (stream.size() * Passes), stream.size(), Passes, stored / Passes);
+  if (not stored)
+     failed++;
+}
+
+int main(void) {
+  Singles();
+  Multi();
+  Eviction();
+  Speed();
+  return failed ? 1 : 0;
+}
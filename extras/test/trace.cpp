@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Traced transport: the driver on a RDA5807M_Traced transport compiles
+// warning free, records register accesses and works with the helpers.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Scan.h"
+#include "shared.h"
+
+typedef RDA5807M_Traced<RDA5807M_SimBus, 64> TracedBus;
+
+int main(void) {
+  RDA5807M_Sim chip;
+  RDA5807M_Driver<TracedBus> radio(chip);
+  radio.Begin(RDA5807M_PowerUpImage(DefaultConfig));
+  radio.Bus().Trace().Clear();
+  radio.Volume(3);
+  radio.ReadStatus();
+  const TracedBus::TraceBuffer& trace = radio.Bus().Trace();
+  // the helpers take any driver.
+  RDA5807M_Scanner<TracedBus> scan(radio);
+  printf("%u accesses traced, scanner %s\n", trace.Size(), scan.Busy() ? "busy" : "idle");
+  // one random write of 0x05, then 6 status words in one burst.
+  return (trace.Size() == 7) and (trace[0].Register == 0x05) ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * RDA5807M single-chip I2C FM stereo radio arduino library
+ * Copyright (C) 2022  Winfried Koehler
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ * 
+ * The latest version of this library can always be found at it's github page,
+ * https://github.com/wirbel-at-vdr-portal/RDA5807M
+ ******************************************************************************/
+// Band scan split across 1..4 simulated tuners against one RDA5807M_Scanner:
+// same table for every table size, and the scan time per tuner count.
+
+#include <stdio.h>
+#include "RDA5807M.h"
+#include "RDA5807M_Sim.h"
+#include "RDA5807M_Tuners.h"
+#include "shared.h"
+
+static RDA5807M_Sim::Station band[] = {
+  {  87600, 45, true,  0, 0, 0, 0 }, {  87800, 30, false, 0, 0, 0, 0 },
+  {  88100, 52, true,  0, 0, 0, 0 }, {  88400, 30, true,  0, 0, 0, 0 },
+  {  88900, 38, true,  0, 0, 0, 0 }, {  93600, 60, true,  0, 0, 0, 0 },
+  { 107900, 28, false, 0, 0, 0, 0 },
+  };
+
+typedef RDA5807M_Driver<SharedBus> Radio;
+
+static void Irq(void* Context) { ((Radio*) Context)->Interrupt(); }
+
+struct Rig {
+  RDA5807M_Sim chip[4];
+  Radio* radio[4];
+  Rig(bool Irq_) {
+    for(int n=0; n<4; n++) {
+       chip[n].Stations(band, sizeof(band) / sizeof(band[0]));
+       radio[n] = new Radio(SharedBus(chip[n]));
+       if (Irq_)
+          chip[n].OnInterrupt(Irq, radio[n]);
+       radio[n]->Begin(RDA5807M_PowerUpImage(DefaultConfig));
+       radio[n]->AsyncInterrupt(Irq_);
+       TuneTo(*radio[n], 121); // 99.1MHz
+       }
+  }
+  ~Rig() { for(int n=0; n<4; n++) delete radio[n]; }
+};
+
+template<uint8_t N>
+static RDA5807M_Tuners<SharedBus, N>* Make(Rig& r);
+template<> RDA5807M_Tuners<SharedBus, 1>* Make<1>(Rig& r) { return new RDA5807M_Tuners<SharedBus, 1>(*r.radio[0]); }
+template<> RDA5807M_Tuners<SharedBus, 2>* Make<2>(Rig& r) { return new RDA5807M_Tuners<SharedBus, 2>(*r.radio[0], *r.radio[1]); }
+template<> RDA5807M_Tuners<SharedBus, 3>* Make<3>(Rig& r) { return new RDA5807M_Tuners<SharedBus, 3>(*r.radio[0], *r.radio[1], *r.radio[2]); }
+template<> RDA5807M_Tuners<SharedBus, 4>* Make<4>(Rig& r) { return new RDA5807M_Tuners<SharedBus, 4>(*r.radio[0], *r.radio[1], *r.radio[2], *r.radio[3]); }
+
+static int failed = 0;
+
+template<uint8_t N>
+static void Run(bool Irq_, uint8_t Size, const RDA5807M_Station* Expect, uint8_t Count) {
+  Rig r(Irq_);
+  RDA5807M_Tuners<SharedBus, N>* t = Make<N>(r);
+  RDA5807M_Station table[32];
+  uint64_t start = SharedBus::Now;
+  if (not t->Start(table, Size)) {
+     printf("%u tuner(s): Start() failed\n", N);
+     failed++;
+     }
+  while(t->Step());
+  bool same = t->Found() == Count;
+  for(uint8_t i=0; same and (i<Count); i++)
+     same = (table[i].Channel == Expect[i].Channel) and (table[i].Rssi == Expect[i].Rssi);
+  if (not same)
+     failed++;
+  printf("  %u tuner(s): %5lu ms, %u stations, %s\n", N,
+         (unsigned long) ((SharedBus::Now - start) / 1000), t->Found(),
+         same ? "same as one scanner" : "DIFFERENT");
+  delete t;
+}
+
+int main(void) {
+  for(int irq=0; irq<2; irq++) {
+     for(uint8_t size=2; size<=16; size*=2) {
+        // reference: one scanner.
+        Rig r(irq);
+        RDA5807M_Scanner<SharedBus> scan(*r.radio[0]);
+        RDA5807M_Station expect[16];
+        scan.Start(expect, size);
+        while(scan.Step());
+        printf("%s, table of %u: one scanner found %u\n", irq ? "irq" : "polled", size, scan.Found());
+        Run<1>(irq, size, expect, scan.Found());
+        Run<2>(irq, size, expect, scan.Found());
+        Run<3>(irq, size, expect, scan.Found());
+        Run<4>(irq, size, expect, scan.Found());
+        }
+     }
+  return failed ? 1 : 0;
+}